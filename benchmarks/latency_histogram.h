@@ -0,0 +1,127 @@
+// Copyright 2025 Dr. Matthias Hölzl
+
+// latency_histogram.h - HDR-style latency histogram for the benchmark harness
+//
+// Values are bucketed log-linearly: each power of two is split into
+// 2^SubBucketBits equal sub-buckets, so every recorded value is represented
+// with a relative error below 2^-SubBucketBits while the histogram stays a
+// small fixed-size array. The maximum is tracked exactly.
+
+#pragma once
+#ifndef INLINE_POLY_LATENCY_HISTOGRAM_H
+#define INLINE_POLY_LATENCY_HISTOGRAM_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+
+namespace bench
+{
+
+    template <unsigned SubBucketBits = 4>
+    class latency_histogram
+    {
+    public:
+        static constexpr unsigned      sub_buckets = 1u << SubBucketBits;
+        static constexpr unsigned      magnitudes  = 64 - SubBucketBits + 1;
+        static constexpr std::uint64_t linear_max  = sub_buckets;
+
+        void record(std::uint64_t value) noexcept
+        {
+            ++counts_[bucket_of(value)];
+            ++total_;
+            max_ = std::max(max_, value);
+            min_ = std::min(min_, value);
+            sum_ += value;
+        }
+
+        // Smallest bucket upper bound below which `q` (0..1) of the samples lie
+        [[nodiscard]] std::uint64_t percentile(double q) const noexcept
+        {
+            if (total_ == 0)
+            {
+                return 0;
+            }
+            const auto rank = static_cast<std::uint64_t>(
+                q * static_cast<double>(total_ - 1) + 1.0);
+            std::uint64_t seen = 0;
+            for (std::size_t i = 0; i < counts_.size(); ++i)
+            {
+                seen += counts_[i];
+                if (seen >= rank)
+                {
+                    return std::min(upper_bound_of(i), max_);
+                }
+            }
+            return max_;
+        }
+
+        void merge(const latency_histogram& other) noexcept
+        {
+            for (std::size_t i = 0; i < counts_.size(); ++i)
+            {
+                counts_[i] += other.counts_[i];
+            }
+            total_ += other.total_;
+            sum_   += other.sum_;
+            max_    = std::max(max_, other.max_);
+            min_    = std::min(min_, other.min_);
+        }
+
+        [[nodiscard]] std::uint64_t count() const noexcept
+        {
+            return total_;
+        }
+        [[nodiscard]] std::uint64_t max() const noexcept
+        {
+            return max_;
+        }
+        [[nodiscard]] std::uint64_t min() const noexcept
+        {
+            return total_ ? min_ : 0;
+        }
+        [[nodiscard]] double mean() const noexcept
+        {
+            return total_ ? static_cast<double>(sum_) /
+                                static_cast<double>(total_)
+                          : 0.0;
+        }
+
+    private:
+        // Values below linear_max map 1:1; above, the top SubBucketBits + 1
+        // significant bits select the bucket within the value's magnitude.
+        static std::size_t bucket_of(std::uint64_t value) noexcept
+        {
+            if (value < linear_max)
+            {
+                return static_cast<std::size_t>(value);
+            }
+            const unsigned magnitude =
+                static_cast<unsigned>(std::bit_width(value)) - SubBucketBits;
+            const auto sub = static_cast<unsigned>(value >> (magnitude - 1)) -
+                             sub_buckets;
+            return magnitude * sub_buckets + sub;
+        }
+
+        static std::uint64_t upper_bound_of(std::size_t bucket) noexcept
+        {
+            if (bucket < linear_max)
+            {
+                return bucket;
+            }
+            const std::size_t   magnitude = bucket / sub_buckets;
+            const std::uint64_t sub       = bucket % sub_buckets + sub_buckets;
+            return ((sub + 1) << (magnitude - 1)) - 1;
+        }
+
+        std::array<std::uint64_t, magnitudes * sub_buckets> counts_{};
+        std::uint64_t total_ = 0;
+        std::uint64_t sum_   = 0;
+        std::uint64_t max_   = 0;
+        std::uint64_t min_   = UINT64_MAX;
+    };
+
+} // namespace bench
+
+#endif // INLINE_POLY_LATENCY_HISTOGRAM_H
@@ -0,0 +1,453 @@
+// Copyright 2025 Dr. Matthias Hölzl
+// stress_latency.cpp - Randomized stress test with per-operation tail latency
+//
+// Runs a long randomized mix of container operations on a poly_vector filled
+// with types of varied traits (trivial payload, std::string, move-only), checks
+// the container against a shadow model along the way and reports per-operation
+// latency percentiles. Latencies are additionally split by fill level so that
+// operations whose cost grows with the container size stand out.
+//
+// Usage: stress_latency [--ops N] [--seed S] [--check-every K]
+
+#include "../include/inline_poly.h"
+#include "latency_histogram.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+    // =============================================================================
+    // Element Types
+    // =============================================================================
+
+    enum class kind : std::uint8_t
+    {
+        trivial,
+        text,
+        move_only
+    };
+
+    struct Payload
+    {
+        virtual ~Payload()                       = default;
+        [[nodiscard]] virtual kind type() const  = 0;
+        [[nodiscard]] virtual long value() const = 0;
+    };
+
+    struct TrivialPayload final : Payload
+    {
+        long a;
+        long b;
+        explicit TrivialPayload(long v) : a(v), b(-v) {}
+        [[nodiscard]] kind type() const override
+        {
+            return kind::trivial;
+        }
+        [[nodiscard]] long value() const override
+        {
+            return a == -b ? a : -1;
+        }
+    };
+
+    struct TextPayload final : Payload
+    {
+        std::string text;
+        // Long enough to defeat the small-string optimization
+        explicit TextPayload(long v) :
+            text("text-payload-with-heap-storage-" + std::to_string(v))
+        {}
+        [[nodiscard]] kind type() const override
+        {
+            return kind::text;
+        }
+        [[nodiscard]] long value() const override
+        {
+            return std::stol(text.substr(text.rfind('-') + 1));
+        }
+    };
+
+    struct MoveOnlyPayload final : Payload
+    {
+        std::unique_ptr<long> boxed;
+        explicit MoveOnlyPayload(long v) : boxed(std::make_unique<long>(v)) {}
+        [[nodiscard]] kind type() const override
+        {
+            return kind::move_only;
+        }
+        [[nodiscard]] long value() const override
+        {
+            return boxed ? *boxed : -1;
+        }
+    };
+
+    using PayloadTypes =
+        inline_poly::type_list<TrivialPayload, TextPayload, MoveOnlyPayload>;
+    using PayloadConfig = inline_poly::slot_config<PayloadTypes>;
+
+    constexpr std::size_t Capacity = 1024;
+    using StressVector =
+        inline_poly::vector<Payload, Capacity, PayloadConfig::size,
+                            PayloadConfig::alignment>;
+
+    // Shadow model entry mirroring one container element
+    struct model_entry
+    {
+        kind type;
+        long value;
+    };
+
+    // =============================================================================
+    // Operations and Latency Bookkeeping
+    // =============================================================================
+
+    enum op : std::size_t
+    {
+        op_emplace_back,
+        op_emplace,
+        op_erase,
+        op_pop_back,
+        op_clear,
+        op_copy,
+        op_move,
+        op_count
+    };
+
+    constexpr std::array<const char*, op_count> op_names = {
+        "emplace_back", "emplace", "erase", "pop_back", "clear", "copy", "move"};
+
+    // Relative weights of the randomized operation mix. Growth operations
+    // outweigh removals and clears are rare, so the fill level sweeps the
+    // whole capacity between clears.
+    constexpr std::array<unsigned, op_count> op_weights = {3000, 1600, 1600, 1200,
+                                                           1,    100,  100};
+
+    // Latencies are also split into fill-level bands (quarters of capacity)
+    constexpr std::size_t band_count = 4;
+
+    using histogram = bench::latency_histogram<>;
+
+    struct op_stats
+    {
+        histogram                         all;
+        std::array<histogram, band_count> by_band;
+    };
+
+    std::size_t band_of(std::size_t size)
+    {
+        return std::min(band_count - 1, size * band_count / Capacity);
+    }
+
+    // =============================================================================
+    // Invariant Checks
+    // =============================================================================
+
+    std::size_t g_failures = 0;
+
+    void fail(const char* what, std::size_t op_index)
+    {
+        if (g_failures++ < 10)
+        {
+            std::fprintf(stderr, "invariant violated after op %zu: %s\n",
+                         op_index, what);
+        }
+    }
+
+    bool copyable(const std::vector<model_entry>& model)
+    {
+        for (const auto& entry : model)
+        {
+            if (entry.type == kind::move_only)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void check(const StressVector& vec, const std::vector<model_entry>& model,
+               std::size_t op_index)
+    {
+        if (vec.size() != model.size())
+        {
+            fail("size mismatch", op_index);
+            return;
+        }
+        // Empty containers report the capabilities of their history, so only
+        // non-empty ones are required to agree with their contents
+        if (!model.empty() && vec.is_copyable() != copyable(model))
+        {
+            fail("is_copyable() disagrees with contents", op_index);
+        }
+        if (!vec.is_movable())
+        {
+            fail("is_movable() false although all types are movable", op_index);
+        }
+        std::size_t i = 0;
+        for (const Payload* p : vec)
+        {
+            if (p == nullptr || p->type() != model[i].type ||
+                p->value() != model[i].value)
+            {
+                fail("element mismatch", op_index);
+                return;
+            }
+            ++i;
+        }
+    }
+
+    // =============================================================================
+    // Driver
+    // =============================================================================
+
+    void emplace_kind(StressVector& vec, std::size_t index, kind k, long v)
+    {
+        auto pos = vec.begin() + static_cast<std::ptrdiff_t>(index);
+        switch (k)
+        {
+            case kind::trivial:
+                vec.emplace<TrivialPayload>(pos, v);
+                break;
+            case kind::text:
+                vec.emplace<TextPayload>(pos, v);
+                break;
+            case kind::move_only:
+                vec.emplace<MoveOnlyPayload>(pos, v);
+                break;
+        }
+    }
+
+    void emplace_back_kind(StressVector& vec, kind k, long v)
+    {
+        switch (k)
+        {
+            case kind::trivial:
+                vec.emplace_back<TrivialPayload>(v);
+                break;
+            case kind::text:
+                vec.emplace_back<TextPayload>(v);
+                break;
+            case kind::move_only:
+                vec.emplace_back<MoveOnlyPayload>(v);
+                break;
+        }
+    }
+
+    std::uint64_t elapsed_ns(std::chrono::steady_clock::time_point start)
+    {
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start)
+                .count());
+    }
+
+    void print_report(const std::array<op_stats, op_count>& stats)
+    {
+        std::printf("\n%-13s %9s %8s %8s %8s %9s  %s\n", "operation", "count",
+                    "p50", "p99", "p99.9", "max", "p50 by fill level (ns)");
+        for (std::size_t o = 0; o < op_count; ++o)
+        {
+            const auto& s = stats[o];
+            std::printf("%-13s %9llu %8llu %8llu %8llu %9llu  ", op_names[o],
+                        static_cast<unsigned long long>(s.all.count()),
+                        static_cast<unsigned long long>(s.all.percentile(0.50)),
+                        static_cast<unsigned long long>(s.all.percentile(0.99)),
+                        static_cast<unsigned long long>(s.all.percentile(0.999)),
+                        static_cast<unsigned long long>(s.all.max()));
+
+            for (const auto& band : s.by_band)
+            {
+                std::printf("%7llu ", static_cast<unsigned long long>(
+                                          band.percentile(0.50)));
+            }
+
+            // Flag operations whose median cost grows with the fill level
+            const auto low =
+                std::max<std::uint64_t>(s.by_band.front().percentile(0.50), 1);
+            const auto high = s.by_band.back().percentile(0.50);
+            if (s.by_band.front().count() && s.by_band.back().count() &&
+                high > 4 * low)
+            {
+                std::printf(" <- grows with size (x%.1f)",
+                            static_cast<double>(high) / static_cast<double>(low));
+            }
+            std::printf("\n");
+        }
+        std::printf("(ns; fill-level bands are quarters of capacity %zu)\n",
+                    Capacity);
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::size_t   total_ops   = 1'000'000;
+    std::uint64_t seed        = 0x5eed;
+    std::size_t   check_every = 997;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (std::strcmp(argv[i], "--ops") == 0)
+        {
+            total_ops = std::strtoull(argv[i + 1], nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--seed") == 0)
+        {
+            seed = std::strtoull(argv[i + 1], nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--check-every") == 0)
+        {
+            check_every = std::max<std::size_t>(
+                1, std::strtoull(argv[i + 1], nullptr, 10));
+        }
+    }
+
+    std::printf("=== inline_poly stress/latency harness ===\n");
+    std::printf("ops=%zu seed=%llu capacity=%zu slot=%zu bytes\n", total_ops,
+                static_cast<unsigned long long>(seed), Capacity,
+                PayloadConfig::size);
+
+    std::mt19937_64                         rng(seed);
+    std::discrete_distribution<std::size_t> pick_op(op_weights.begin(),
+                                                    op_weights.end());
+    std::uniform_int_distribution<int>      pick_kind(0, 2);
+
+    auto                           vec   = std::make_unique<StressVector>();
+    auto                           other = std::make_unique<StressVector>();
+    std::vector<model_entry>       model;
+    std::array<op_stats, op_count> stats{};
+    long                           next_value = 0;
+
+    model.reserve(Capacity);
+
+    for (std::size_t n = 0; n < total_ops; ++n)
+    {
+        std::size_t       o    = pick_op(rng);
+        const std::size_t size = vec->size();
+
+        // Redirect operations that are impossible in the current state
+        if (size == Capacity && (o == op_emplace_back || o == op_emplace))
+        {
+            o = op_erase;
+        }
+        if (size == 0 && (o == op_erase || o == op_pop_back))
+        {
+            o = op_emplace_back;
+        }
+
+        const auto        k     = static_cast<kind>(pick_kind(rng));
+        const long        v     = next_value++;
+        const std::size_t index = size ? std::uniform_int_distribution<
+                                             std::size_t>(0, size - 1)(rng)
+                                       : 0;
+
+        bool       copied = false;
+        const auto start  = std::chrono::steady_clock::now();
+        switch (o)
+        {
+            case op_emplace_back:
+                emplace_back_kind(*vec, k, v);
+                break;
+            case op_emplace:
+                emplace_kind(*vec, index, k, v);
+                break;
+            case op_erase:
+                vec->erase(vec->begin() + static_cast<std::ptrdiff_t>(index));
+                break;
+            case op_pop_back:
+                vec->pop_back();
+                break;
+            case op_clear:
+                vec->clear();
+                break;
+            case op_copy:
+                try
+                {
+                    *other = *vec;
+                    copied = true;
+                    if (!copyable(model))
+                    {
+                        fail("copy of move-only contents succeeded", n);
+                    }
+                }
+                catch (const std::logic_error&)
+                {
+                    if (!model.empty() && copyable(model))
+                    {
+                        fail("copy of copyable contents threw", n);
+                    }
+                }
+                break;
+            case op_move:
+                *other = std::move(*vec);
+                std::swap(vec, other);
+                break;
+            default:
+                break;
+        }
+        const std::uint64_t ns = elapsed_ns(start);
+
+        stats[o].all.record(ns);
+        stats[o].by_band[band_of(size)].record(ns);
+
+        // Mirror the operation in the shadow model
+        switch (o)
+        {
+            case op_emplace_back:
+                model.push_back({k, v});
+                break;
+            case op_emplace:
+                model.insert(model.begin() + static_cast<std::ptrdiff_t>(index),
+                             {k, v});
+                break;
+            case op_erase:
+                model.erase(model.begin() + static_cast<std::ptrdiff_t>(index));
+                break;
+            case op_pop_back:
+                model.pop_back();
+                break;
+            case op_clear:
+                model.clear();
+                break;
+            case op_copy:
+                if (copied)
+                {
+                    check(*other, model, n);
+                }
+                break;
+            case op_move:
+                if (!other->empty())
+                {
+                    fail("moved-from vector not empty", n);
+                }
+                break;
+            default:
+                break;
+        }
+
+        if (n % check_every == 0)
+        {
+            check(*vec, model, n);
+        }
+    }
+    check(*vec, model, total_ops);
+
+    print_report(stats);
+
+    if (g_failures != 0)
+    {
+        std::printf("\nFAILED: %zu invariant violations\n", g_failures);
+        return EXIT_FAILURE;
+    }
+    std::printf("\nAll invariants held.\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,97 @@
+// Copyright 2025 Dr. Matthias Hölzl
+#include <iostream>
+#include <memory>
+#include "../../include/inline_poly_ecs.h"
+
+// Example: Archetype-based ECS with dense per-component columns
+
+namespace ecs = inline_poly::ecs;
+
+struct Position
+{
+    float x, y;
+};
+
+struct Velocity
+{
+    float dx, dy;
+};
+
+struct Health
+{
+    int current;
+};
+
+struct Projectile
+{
+    int damage;
+};
+
+using Components = inline_poly::type_list<Position, Velocity, Health, Projectile>;
+using World      = ecs::world<Components, 256, 8, 256>;
+
+// Static storage: the world reserves its column store up front
+static World world;
+
+int main()
+{
+    std::cout << "=== Archetype ECS Example ===\n\n";
+    std::cout << "World footprint: " << sizeof(World) << " bytes\n\n";
+
+    for (int i = 0; i < 8; ++i)
+    {
+        world.create(Position{float(i), 0}, Velocity{1, 0.5f},
+                     Health{10 + 5 * i});
+    }
+    for (int i = 0; i < 4; ++i)
+    {
+        world.create(Position{0, float(i)}, Velocity{4, 0}, Projectile{7});
+    }
+    world.create(Position{50, 50}, Health{100}); // static tower
+
+    std::cout << "Entities: " << world.size()
+              << ", archetypes: " << world.archetype_count() << "\n";
+
+    ecs::command_buffer<World> commands(world);
+    for (int frame = 0; frame < 3; ++frame)
+    {
+        // Movement: one dense loop per matching archetype
+        world.query<Position, const Velocity>().each_chunk(
+            [](std::size_t count, Position* p, const Velocity* v)
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    p[i].x += v[i].dx;
+                    p[i].y += v[i].dy;
+                }
+            });
+
+        // Damage: structural changes are deferred until the query finishes
+        world.query<Health>().each_with_entity(
+            [&](ecs::entity e, Health& health)
+            {
+                health.current -= 7;
+                if (health.current <= 0)
+                {
+                    commands.destroy(e);
+                }
+                else if (health.current < 15)
+                {
+                    commands.remove<Velocity>(e); // too weak to move
+                }
+            });
+        commands.flush();
+
+        std::cout << "Frame " << frame << ": " << world.size()
+                  << " entities, "
+                  << world.query<const Velocity>().count() << " moving\n";
+    }
+
+    std::cout << "\nProjectile positions:\n";
+    world.query<const Position, const Projectile>().each(
+        [](const Position& p, const Projectile& proj)
+        {
+            std::cout << "  (" << p.x << ", " << p.y << ") damage "
+                      << proj.damage << "\n";
+        });
+}
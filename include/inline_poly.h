@@ -9,12 +9,17 @@
 
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <cassert>
+#include <chrono>
 #include <concepts>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <format>
+#include <functional>
 #include <iterator>
+#include <new>
 #include <stdexcept>
 #include <type_traits>
 #include <utility>
@@ -46,19 +51,88 @@ namespace inline_poly
         // Copy assignment function (assigns dst from src, destroys old dst)
         using copy_assignment_fn = void (*)(void* dst, const void* src);
 
+        // Relocate function (move constructs dst from src, then destroys src)
+        using relocate_fn = void (*)(void* dst, void* src) noexcept;
+
+        // Equality of two objects of the same type
+        using equal_fn = bool (*)(const void* lhs, const void* rhs);
+
+        // Hash of an object's value
+        using hash_fn = std::size_t (*)(const void* obj);
+
         destructor_fn       destroy        = nullptr;
         move_constructor_fn move_construct = nullptr;
         move_assignment_fn  move_assign    = nullptr;
         copy_constructor_fn copy_construct = nullptr;
         copy_assignment_fn  copy_assign    = nullptr;
+        relocate_fn         relocate       = nullptr;
+        equal_fn            equal          = nullptr; // Optional
+        hash_fn             hash           = nullptr; // Optional
+
+        std::size_t size                     = 0;
+        std::size_t alignment                = 0;
+        bool        is_trivially_copyable    = false;
+        bool        is_trivially_relocatable = false;
+        bool        is_copy_constructible    = false;
+        bool        is_move_constructible    = false;
+    };
+
+    // Opt-in trait for types whose objects may be moved to a new address by
+    // copying their bytes, which ends the source object's lifetime without
+    // running its destructor. This holds for most polymorphic types (the
+    // vtable pointer does not depend on the object's address) unless they
+    // store pointers into themselves or register their address elsewhere.
+    // Specialize it as std::true_type to let containers relocate such types
+    // with memcpy/memmove; trivially copyable types qualify by default.
+    template <typename T>
+    struct is_trivially_relocatable
+        : std::bool_constant<std::is_trivially_copyable_v<T>>
+    {};
+
+    template <typename T>
+    inline constexpr bool is_trivially_relocatable_v =
+        is_trivially_relocatable<T>::value;
+
+    // Types whose values can be hashed: a std::hash specialization or a
+    // hash_value(const T&) function found by argument-dependent lookup
+    template <typename T>
+    concept StdHashable = requires(const T& value) {
+        { std::hash<T>{}(value) } -> std::convertible_to<std::size_t>;
+    };
 
-        std::size_t size                  = 0;
-        std::size_t alignment             = 0;
-        bool        is_trivially_copyable = false;
-        bool        is_copy_constructible = false;
-        bool        is_move_constructible = false;
+    template <typename T>
+    concept AdlHashable = requires(const T& value) {
+        { hash_value(value) } -> std::convertible_to<std::size_t>;
     };
 
+    // Types whose object representation determines their value, so equality
+    // and hashing may work on the raw bytes
+    template <typename T>
+    concept BytewiseComparable = std::is_trivially_copyable_v<T> &&
+                                 std::has_unique_object_representations_v<T>;
+
+    namespace detail
+    {
+        // FNV-1a over raw bytes
+        inline std::size_t hash_bytes(const void* data, std::size_t size) noexcept
+        {
+            const auto* bytes = static_cast<const unsigned char*>(data);
+            std::size_t hash  = 14695981039346656037ull;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                hash = (hash ^ bytes[i]) * 1099511628211ull;
+            }
+            return hash;
+        }
+
+        inline std::size_t hash_combine(std::size_t seed,
+                                        std::size_t value) noexcept
+        {
+            return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) +
+                           (seed >> 2));
+        }
+    } // namespace detail
+
     // Type operations factory - generates operations for a specific type
     // Returns a static instance to avoid heap allocations
     template <typename T>
@@ -75,11 +149,12 @@ namespace inline_poly
         {
             type_operations ops;
 
-            ops.size                  = sizeof(T);
-            ops.alignment             = alignof(T);
-            ops.is_trivially_copyable = std::is_trivially_copyable_v<T>;
-            ops.is_copy_constructible = std::is_copy_constructible_v<T>;
-            ops.is_move_constructible = std::is_move_constructible_v<T>;
+            ops.size                     = sizeof(T);
+            ops.alignment                = alignof(T);
+            ops.is_trivially_copyable    = std::is_trivially_copyable_v<T>;
+            ops.is_trivially_relocatable = is_trivially_relocatable_v<T>;
+            ops.is_copy_constructible    = std::is_copy_constructible_v<T>;
+            ops.is_move_constructible    = std::is_move_constructible_v<T>;
 
             // Destructor (always needed for polymorphic types)
             ops.destroy = [](void* obj) noexcept { static_cast<T*>(obj)->~T(); };
@@ -89,6 +164,14 @@ namespace inline_poly
             {
                 ops.move_construct = [](void* dst, void* src) noexcept
                 { new (dst) T(std::move(*static_cast<T*>(src))); };
+
+                // One indirect call instead of move_construct + destroy
+                ops.relocate = [](void* dst, void* src) noexcept
+                {
+                    T* source = static_cast<T*>(src);
+                    new (dst) T(std::move(*source));
+                    source->~T();
+                };
             }
 
             if constexpr (std::is_move_assignable_v<T>)
@@ -110,6 +193,37 @@ namespace inline_poly
                 { *static_cast<T*>(dst) = *static_cast<const T*>(src); };
             }
 
+            // Value comparison, if the type defines it
+            if constexpr (std::equality_comparable<T>)
+            {
+                ops.equal = [](const void* lhs, const void* rhs)
+                {
+                    return static_cast<bool>(*static_cast<const T*>(lhs) ==
+                                             *static_cast<const T*>(rhs));
+                };
+            }
+            else if constexpr (BytewiseComparable<T>)
+            {
+                ops.equal = [](const void* lhs, const void* rhs)
+                { return std::memcmp(lhs, rhs, sizeof(T)) == 0; };
+            }
+
+            if constexpr (StdHashable<T>)
+            {
+                ops.hash = [](const void* obj) -> std::size_t
+                { return std::hash<T>{}(*static_cast<const T*>(obj)); };
+            }
+            else if constexpr (AdlHashable<T>)
+            {
+                ops.hash = [](const void* obj) -> std::size_t
+                { return hash_value(*static_cast<const T*>(obj)); };
+            }
+            else if constexpr (BytewiseComparable<T>)
+            {
+                ops.hash = [](const void* obj)
+                { return detail::hash_bytes(obj, sizeof(T)); };
+            }
+
             return ops;
         }
     };
@@ -164,6 +278,54 @@ namespace inline_poly
         }
     }
 
+    // Helper to move an object to dst and end its lifetime at src
+    inline void safe_relocate(void* dst, void* src, const type_operations& ops)
+    {
+        if (ops.is_trivially_copyable || ops.is_trivially_relocatable)
+        {
+            std::memcpy(dst, src, ops.size);
+        }
+        else if (ops.relocate)
+        {
+            ops.relocate(dst, src);
+        }
+        else
+        {
+            safe_move_construct(dst, src, ops);
+            if (ops.destroy)
+            {
+                ops.destroy(src);
+            }
+        }
+    }
+
+    // Helper to compare two objects given their type operations. Objects of
+    // different types are never equal; this is decided by the ops pointers
+    // alone, without calling into either type.
+    inline bool safe_equal(const void* lhs, const type_operations& lhs_ops,
+                           const void* rhs, const type_operations& rhs_ops)
+    {
+        if (&lhs_ops != &rhs_ops)
+        {
+            return false;
+        }
+        if (!lhs_ops.equal)
+        {
+            throw std::logic_error("Type has no equality comparison");
+        }
+        return lhs_ops.equal(lhs, rhs);
+    }
+
+    // Helper to hash an object using its type operations
+    inline std::size_t safe_hash(const void* obj, const type_operations& ops)
+    {
+        if (!ops.hash)
+        {
+            throw std::logic_error("Type has no hash function");
+        }
+        return ops.hash(obj);
+    }
+
     // Helper to safely destroy objects
     inline void safe_destroy(void* obj, const type_operations& ops) noexcept
     {
@@ -228,11 +390,228 @@ namespace inline_poly
         std::derived_from<Derived, Base> && (sizeof(Derived) <= SlotSize) &&
         (alignof(Derived) <= Alignment);
 
+    // =============================================================================
+    // Policies - Compile-time customization hooks for the containers
+    // =============================================================================
+
+    // Trace policy that records nothing. Its scope is an empty type with a
+    // trivial constructor, so instrumented code compiles away completely.
+    struct null_trace
+    {
+        struct scope
+        {
+            constexpr explicit scope(const char* /*name*/,
+                                     std::size_t /*count*/ = 0) noexcept
+            {}
+        };
+    };
+
+    // Default container policy. To customize a container, derive from it and
+    // override individual members, e.g.
+    //   struct traced : inline_poly::default_policy
+    //   {
+    //       using trace = inline_poly::chrome_trace;
+    //   };
+    struct default_policy
+    {
+        // Span recorder for expensive operations (see inline_poly_trace.h)
+        using trace = null_trace;
+
+        // poly_vector::erase_deferred() compacts automatically once this
+        // fraction of the slots holds tombstones; 0 leaves compaction to
+        // explicit compact() calls
+        static constexpr double tombstone_compaction_ratio = 0.0;
+
+        // Exact dynamic types whose slot indices the containers track for
+        // indices_of<T>() and for_each<T>(), e.g. type_list<Circle, Square>
+        using indexed_types = type_list<>;
+    };
+
+    namespace detail
+    {
+        // Forward range over the positions of the set bits in an array of
+        // 64-bit words
+        template <size_t Words>
+        class set_bits_view
+        {
+        public:
+            class iterator
+            {
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type        = std::size_t;
+                using difference_type   = std::ptrdiff_t;
+                using pointer           = void;
+                using reference         = std::size_t;
+
+                iterator() = default;
+                iterator(const std::uint64_t* words, std::size_t word) noexcept :
+                    words_(words), word_(word)
+                {
+                    skip_empty();
+                }
+
+                reference operator*() const noexcept
+                {
+                    return word_ * 64 +
+                           static_cast<std::size_t>(std::countr_zero(rest_));
+                }
+                iterator& operator++() noexcept
+                {
+                    rest_ &= rest_ - 1;
+                    if (rest_ == 0)
+                    {
+                        ++word_;
+                        skip_empty();
+                    }
+                    return *this;
+                }
+                iterator operator++(int) noexcept
+                {
+                    iterator tmp = *this;
+                    ++*this;
+                    return tmp;
+                }
+                bool operator==(const iterator& other) const noexcept
+                {
+                    return word_ == other.word_ && rest_ == other.rest_;
+                }
+
+            private:
+                void skip_empty() noexcept
+                {
+                    for (; word_ < Words; ++word_)
+                    {
+                        rest_ = words_[word_];
+                        if (rest_ != 0)
+                        {
+                            return;
+                        }
+                    }
+                    rest_ = 0;
+                }
+
+                const std::uint64_t* words_ = nullptr;
+                std::size_t          word_  = Words;
+                std::uint64_t        rest_  = 0;
+            };
+
+            explicit set_bits_view(const std::uint64_t* words) noexcept :
+                words_(words)
+            {}
+
+            iterator begin() const noexcept
+            {
+                return iterator(words_, 0);
+            }
+            iterator end() const noexcept
+            {
+                return iterator(words_, Words);
+            }
+            [[nodiscard]] std::size_t size() const noexcept
+            {
+                std::size_t count = 0;
+                for (std::size_t w = 0; w < Words; ++w)
+                {
+                    count += static_cast<std::size_t>(std::popcount(words_[w]));
+                }
+                return count;
+            }
+            [[nodiscard]] bool empty() const noexcept
+            {
+                return begin() == end();
+            }
+
+        private:
+            const std::uint64_t* words_;
+        };
+
+        // Secondary index for a policy's indexed_types: one bitset of slot
+        // indices per registered type, updated whenever a slot changes
+        template <typename TypeList, size_t N>
+        class type_slot_index;
+
+        template <typename... Types, size_t N>
+        class type_slot_index<type_list<Types...>, N>
+        {
+            static constexpr size_t words = (N + 63) / 64;
+
+            using bitset = std::array<std::uint64_t, words>;
+
+            std::array<bitset, sizeof...(Types)> bits_{};
+
+        public:
+            using view = set_bits_view<words>;
+
+            // Position of T in the type list or sizeof...(Types)
+            template <typename T>
+            static constexpr size_t position = []
+            {
+                size_t k = 0;
+                (void)((std::is_same_v<T, Types> ? false : (++k, true)) && ...);
+                return k;
+            }();
+
+            template <typename T>
+            static constexpr bool contains = position<T> < sizeof...(Types);
+
+            void insert([[maybe_unused]] size_t                 index,
+                        [[maybe_unused]] const type_operations* ops) noexcept
+            {
+                size_t k = 0;
+                (void)((ops == &get_type_ops<Types>()
+                            ? (set(k, index), true)
+                            : (++k, false)) ||
+                       ...);
+            }
+
+            void erase(size_t index) noexcept
+            {
+                for (bitset& bits : bits_)
+                {
+                    bits[index / 64] &= ~(std::uint64_t{1} << (index % 64));
+                }
+            }
+
+            // Move the entry of slot src to the empty slot dst
+            void move(size_t dst, size_t src) noexcept
+            {
+                for (size_t k = 0; k < sizeof...(Types); ++k)
+                {
+                    if ((bits_[k][src / 64] >> (src % 64)) & 1u)
+                    {
+                        bits_[k][src / 64] &= ~(std::uint64_t{1} << (src % 64));
+                        set(k, dst);
+                        return;
+                    }
+                }
+            }
+
+            void clear() noexcept
+            {
+                bits_ = {};
+            }
+
+            template <typename T>
+            [[nodiscard]] view indices_of() const noexcept
+            {
+                return view(bits_[position<T>].data());
+            }
+
+        private:
+            void set(size_t k, size_t index) noexcept
+            {
+                bits_[k][index / 64] |= std::uint64_t{1} << (index % 64);
+            }
+        };
+    } // namespace detail
+
     // --- Unified Array Container ---
     // Automatically enables copy/move based on contained types
 
     template <PolymorphicBase Base, size_t N, size_t SlotSize = sizeof(Base),
-              size_t Alignment = alignof(Base)>
+              size_t   Alignment = alignof(Base),
+              typename Policy    = default_policy>
     class poly_array
     {
     public:
@@ -249,11 +628,18 @@ namespace inline_poly
         using reverse_iterator       = std::reverse_iterator<iterator>;
         using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
+        // Marks an empty slot in the index map written by compact()
+        static constexpr size_type npos = static_cast<size_type>(-1);
+
         static_assert(SlotSize >= sizeof(Base), "SlotSize must hold Base");
         static_assert(Alignment >= alignof(Base),
                       "Alignment must be at least alignof(Base)");
 
     private:
+        using trace_scope = typename Policy::trace::scope;
+        using type_index =
+            detail::type_slot_index<typename Policy::indexed_types, N>;
+
         // Storage for objects and their type information
         struct slot_info
         {
@@ -266,6 +652,24 @@ namespace inline_poly
         bool can_copy_ = false; // Track if all contained types support copying
         bool can_move_ = true;  // Track if all contained types support moving
 
+        // One past the last occupied slot
+        size_type occupied_end_ = 0;
+
+        // Two-level occupancy bitmap for emplace_any(): bit i of
+        // occupied_bits_ is set for an occupied slot, bit w of full_words_
+        // once word w of occupied_bits_ has no free slot left
+        static constexpr size_type bitmap_words = (N + 63) / 64;
+
+        std::array<std::uint64_t, bitmap_words>              occupied_bits_{};
+        std::array<std::uint64_t, (bitmap_words + 63) / 64> full_words_{};
+        size_type                                            occupied_count_ = 0;
+
+        [[no_unique_address]] type_index types_;
+
+        // Slots changed since the active snapshot last copied them
+        std::array<std::uint64_t, bitmap_words> dirty_bits_{};
+        bool                                    snapshot_active_ = false;
+
     public:
         // Default constructor
         poly_array() = default;
@@ -335,6 +739,7 @@ namespace inline_poly
             }
 
             // Clean up existing object if present
+            const type_operations* replaced = slots_[index].ops;
             if (slots_[index].ptr != nullptr)
             {
                 destroy_at(index);
@@ -348,19 +753,116 @@ namespace inline_poly
             auto* new_obj =
                 new (placement_ptr) Derived(std::forward<Args>(args)...);
 
+            // Adding an object can only restrict the capabilities; only
+            // replacing a non-copyable or non-movable object rescans them
+            const bool rescan = replaced && (!replaced->is_copy_constructible ||
+                                             !replaced->is_move_constructible);
+            if (!rescan)
+            {
+                can_copy_ = (occupied_count_ == 0 || can_copy_) &&
+                            ops.is_copy_constructible;
+                can_move_ = (occupied_count_ == 0 || can_move_) &&
+                            ops.is_move_constructible;
+            }
+
             // Update slot info
             slots_[index] = {.ptr = new_obj, .ops = &ops};
+            mark_occupied(index);
 
-            // Update container capabilities and invalidate iterator cache
-            update_capabilities();
+            if (rescan)
+            {
+                update_capabilities();
+            }
             invalidate_cache();
 
             return new_obj;
         }
 
+        // Construct an object in the lowest free slot, found in O(N / 4096)
+        // through the occupancy bitmap instead of a scan of all slots.
+        // Returns the slot index and the new object.
+        template <typename Derived, typename... Args>
+            requires FitsInSlot<Derived, Base, SlotSize, Alignment> &&
+                     std::constructible_from<Derived, Args...>
+        std::pair<size_type, Derived*> emplace_any(Args&&... args)
+        {
+            const size_type index = find_free();
+            if (index == npos)
+            {
+                throw std::out_of_range(
+                    "poly_array::emplace_any() - no free slot");
+            }
+
+            const auto& ops           = get_type_ops<Derived>();
+            void*       placement_ptr = get_storage_slot(index);
+            auto*       new_obj =
+                new (placement_ptr) Derived(std::forward<Args>(args)...);
+
+            // Adding an object can only restrict the capabilities, so no
+            // rescan is needed
+            can_copy_ = (occupied_count_ == 0 || can_copy_) &&
+                        ops.is_copy_constructible;
+            can_move_ = (occupied_count_ == 0 || can_move_) &&
+                        ops.is_move_constructible;
+
+            slots_[index] = {.ptr = new_obj, .ops = &ops};
+            mark_occupied(index);
+            invalidate_cache();
+            return {index, new_obj};
+        }
+
+        // Destroy the object at index and return its slot to emplace_any().
+        // Throws std::logic_error if the slot is already empty. Only
+        // releasing a non-copyable or non-movable object rescans the
+        // capabilities.
+        void release(size_type index)
+        {
+            if (index >= N)
+            {
+                throw std::out_of_range(
+                    std::format("poly_array::release({}) out of bounds", index));
+            }
+            if (slots_[index].ptr == nullptr)
+            {
+                throw std::logic_error(std::format(
+                    "poly_array::release({}) - slot is empty", index));
+            }
+
+            const type_operations& ops = *slots_[index].ops;
+            destroy_at(index);
+            if (occupied_count_ == 0)
+            {
+                can_copy_ = true;
+                can_move_ = true;
+            }
+            else if (!ops.is_copy_constructible || !ops.is_move_constructible)
+            {
+                update_capabilities();
+            }
+            invalidate_cache();
+        }
+
+        // Destroy the object at index and leave the slot empty
+        void reset(size_type index)
+        {
+            if (index >= N)
+            {
+                throw std::out_of_range(
+                    std::format("poly_array::reset({}) out of bounds", index));
+            }
+            if (slots_[index].ptr == nullptr)
+            {
+                return;
+            }
+            destroy_at(index);
+            update_capabilities();
+            invalidate_cache();
+        }
+
         void clear() noexcept
         {
-            for (size_type i = 0; i < N; ++i)
+            [[maybe_unused]] trace_scope span("poly_array::clear", N);
+            for (size_type i = 0; i < occupied_end_; ++i)
             {
                 if (slots_[i].ptr != nullptr)
                 {
@@ -372,6 +874,57 @@ namespace inline_poly
             invalidate_cache();
         }
 
+        // --- Defragmentation ---
+
+        // Relocate the objects into the lowest slots, keeping their relative
+        // order, so they form a dense prefix of occupied_prefix() slots.
+        // Returns the number of objects.
+        size_type compact()
+        {
+            return compact_impl([](size_type, size_type) {});
+        }
+
+        // As compact(), and write N entries to remap_out: for each old index
+        // in order, the new index of its object or npos if it was empty. A
+        // stored index i is patched with remap[i].
+        template <typename OutputIt>
+        size_type compact(OutputIt remap_out)
+        {
+            size_type next_old = 0;
+            const auto emit    = [&](size_type old_index, size_type new_index)
+            {
+                for (; next_old < old_index; ++next_old)
+                {
+                    *remap_out = npos;
+                    ++remap_out;
+                }
+                *remap_out = new_index;
+                ++remap_out;
+                ++next_old;
+            };
+            const size_type live = compact_impl(emit);
+            for (; next_old < N; ++next_old)
+            {
+                *remap_out = npos;
+                ++remap_out;
+            }
+            return live;
+        }
+
+        // One past the last occupied slot: every object lives in
+        // [0, occupied_prefix()), so loops can stop there. Equals the number
+        // of objects right after compact().
+        [[nodiscard]] size_type occupied_prefix() const noexcept
+        {
+            return occupied_end_;
+        }
+
+        // Number of occupied slots
+        [[nodiscard]] size_type occupied_count() const noexcept
+        {
+            return occupied_count_;
+        }
+
         // --- Element Access ---
 
         reference at(size_type index)
@@ -508,50 +1061,391 @@ namespace inline_poly
             return can_move_;
         }
 
-    private:
-        // Pointer cache for iterator support (fixed-size array avoids std::vector
-        // template issues)
-        mutable std::array<Base*, N> ptr_cache_{};
-        mutable bool                 cache_valid_ = false;
+        // --- Incremental Snapshot ---
 
-        void update_ptr_cache() const
+        // Copy of a poly_array built a bounded number of slots at a time, so
+        // snapshotting a large array can be spread over several frames. The
+        // source records every slot that changes after it has been copied
+        // and step() copies those slots again, so the finished copy equals
+        // the source at the moment of completion. Objects modified in place
+        // through their pointers must be reported with touch().
+        //
+        // At most one snapshot per source can be active, and the source must
+        // stay in place until the snapshot is finished or destroyed.
+        class snapshot
         {
-            if (!cache_valid_)
+        public:
+            explicit snapshot(poly_array& source) : source_(&source)
             {
-                for (size_t i = 0; i < N; ++i)
+                if (source.snapshot_active_)
                 {
-                    ptr_cache_[i] = slots_[i].ptr;
+                    throw std::logic_error(
+                        "poly_array::snapshot - a snapshot is already active");
                 }
-                cache_valid_ = true;
+                source.snapshot_active_ = true;
+                source.dirty_bits_      = {};
             }
-        }
-
-        void invalidate_cache() const noexcept
-        {
-            cache_valid_ = false;
-        }
-
-        void* get_storage_slot(size_t index) noexcept
-        {
-            return &storage_[index * SlotSize];
-        }
 
-        const void* get_storage_slot(size_t index) const noexcept
-        {
-            return &storage_[index * SlotSize];
-        }
+            snapshot(const snapshot&)            = delete;
+            snapshot& operator=(const snapshot&) = delete;
 
-        void destroy_at(size_type index) noexcept
-        {
-            if (slots_[index].ptr && slots_[index].ops)
+            ~snapshot()
             {
-                safe_destroy(slots_[index].ptr, *slots_[index].ops);
-                slots_[index] = {};
+                release();
             }
-        }
+
+            // Copy up to max_slots slots: first the slots not visited yet,
+            // then those changed since they were copied. Returns true once
+            // the copy matches the source. Throws std::logic_error for a
+            // non-copyable object or after take(). A slot whose copy throws
+            // stays due and is copied again by the next step.
+            bool step(size_type max_slots)
+            {
+                [[maybe_unused]] trace_scope span("poly_array::snapshot_step",
+                                                  max_slots);
+                if (!source_)
+                {
+                    throw std::logic_error(
+                        "poly_array::snapshot::step() - snapshot already taken");
+                }
+                size_type budget = max_slots;
+                for (; budget > 0 && next_ < N; --budget, ++next_)
+                {
+                    copy_slot(next_);
+                }
+                for (size_type w = 0; budget > 0 && w < bitmap_words;)
+                {
+                    std::uint64_t& word = source_->dirty_bits_[w];
+                    if (word == 0)
+                    {
+                        ++w;
+                        continue;
+                    }
+                    copy_slot(w * 64 +
+                              static_cast<size_type>(std::countr_zero(word)));
+                    --budget;
+                }
+                return done();
+            }
+
+            // Whether every slot has been copied and none changed since
+            [[nodiscard]] bool done() const noexcept
+            {
+                return next_ >= N &&
+                       (!source_ ||
+                        std::ranges::all_of(source_->dirty_bits_,
+                                            [](std::uint64_t word)
+                                            { return word == 0; }));
+            }
+
+            // Slots visited by the first pass so far
+            [[nodiscard]] size_type progress() const noexcept
+            {
+                return next_;
+            }
+
+            // Hand out the finished copy and detach from the source. Throws
+            // std::logic_error if the snapshot is not done.
+            [[nodiscard]] poly_array take()
+            {
+                if (!source_ || !done())
+                {
+                    throw std::logic_error(
+                        "poly_array::snapshot::take() - snapshot not done");
+                }
+                release();
+                copy_.update_capabilities();
+                return std::move(copy_);
+            }
+
+        private:
+            // The dirty bit is cleared only once the slot has been copied
+            void copy_slot(size_type index)
+            {
+                copy_.destroy_at(index);
+
+                const slot_info& slot = source_->slots_[index];
+                if (slot.ptr != nullptr)
+                {
+                    void* dst = copy_.get_storage_slot(index);
+                    safe_copy_construct(dst, source_->get_storage_slot(index),
+                                        *slot.ops);
+                    copy_.slots_[index] = {.ptr = static_cast<Base*>(dst),
+                                           .ops = slot.ops};
+                    copy_.mark_occupied(index);
+                }
+                source_->dirty_bits_[index / 64] &=
+                    ~(std::uint64_t{1} << (index % 64));
+            }
+
+            void release() noexcept
+            {
+                if (source_)
+                {
+                    source_->snapshot_active_ = false;
+                    source_                   = nullptr;
+                }
+            }
+
+            poly_array* source_;
+            poly_array  copy_;
+            size_type   next_ = 0;
+        };
+
+        // Start an incremental copy of this array; see snapshot
+        [[nodiscard]] snapshot begin_snapshot()
+        {
+            return snapshot(*this);
+        }
+
+        // Report that the object at index was modified through its pointer,
+        // so an active snapshot copies it again
+        void touch(size_type index) noexcept
+        {
+            assert(index < N);
+            mark_dirty(index);
+        }
+
+        // --- Per-Type Index ---
+
+        // Indices of the slots holding exactly a T, in ascending order. T
+        // must be listed in the policy's indexed_types; the index is kept up
+        // to date by every modifier, so this costs one word per 64 slots
+        // plus the matches instead of a type check per element.
+        template <typename T>
+            requires type_index::template contains<T>
+        [[nodiscard]] typename type_index::view indices_of() const noexcept
+        {
+            return types_.template indices_of<T>();
+        }
+
+        // Call fn(T&) for every element of exact type T, in index order
+        template <typename T, typename Fn>
+            requires type_index::template contains<T>
+        void for_each(Fn&& fn)
+        {
+            for (const size_type i : indices_of<T>())
+            {
+                fn(static_cast<T&>(*slots_[i].ptr));
+            }
+        }
+        template <typename T, typename Fn>
+            requires type_index::template contains<T>
+        void for_each(Fn&& fn) const
+        {
+            for (const size_type i : indices_of<T>())
+            {
+                fn(static_cast<const T&>(*slots_[i].ptr));
+            }
+        }
+
+        // --- Comparison ---
+
+        // Element-wise equality through the stored types' equal operations.
+        // Slots holding different types compare unequal without calling into
+        // either type. Throws std::logic_error if two objects of a type
+        // without equality have to be compared.
+        friend bool operator==(const poly_array& lhs, const poly_array& rhs)
+        {
+            for (size_type i = 0; i < N; ++i)
+            {
+                if (!lhs.element_equal(i, rhs))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Hash of all elements in order; throws std::logic_error if a stored
+        // type has no hash function
+        [[nodiscard]] std::size_t hash() const
+        {
+            std::size_t seed = N;
+            for (size_type i = 0; i < N; ++i)
+            {
+                const std::size_t value =
+                    slots_[i].ptr
+                        ? safe_hash(get_storage_slot(i), *slots_[i].ops)
+                        : 0;
+                seed = detail::hash_combine(seed, value);
+            }
+            return seed;
+        }
+
+        // Write the indices of the slots whose contents differ between lhs
+        // and rhs to out
+        template <typename OutputIt>
+        friend OutputIt diff(const poly_array& lhs, const poly_array& rhs,
+                             OutputIt out)
+        {
+            for (size_type i = 0; i < N; ++i)
+            {
+                if (!lhs.element_equal(i, rhs))
+                {
+                    *out = i;
+                    ++out;
+                }
+            }
+            return out;
+        }
+
+    private:
+        // Relocate each object to the lowest free slot and call
+        // on_object(old_index, new_index) for every object in order
+        template <typename Fn>
+        size_type compact_impl(Fn&& on_object)
+        {
+            if (!can_move_)
+            {
+                throw std::runtime_error(
+                    "poly_array::compact() - cannot move elements: contained "
+                    "types are neither movable nor copyable.");
+            }
+
+            [[maybe_unused]] trace_scope span("poly_array::compact",
+                                              occupied_end_);
+            size_type write = 0;
+            size_type end   = occupied_end_;
+            for (size_type read = 0; read < end; ++read)
+            {
+                if (slots_[read].ptr == nullptr)
+                {
+                    continue;
+                }
+                if (read != write)
+                {
+                    void* dst = get_storage_slot(write);
+                    safe_relocate(dst, get_storage_slot(read), *slots_[read].ops);
+                    slots_[write] = {.ptr = static_cast<Base*>(dst),
+                                     .ops = slots_[read].ops};
+                    slots_[read]  = {};
+                    mark_free(read);
+                    mark_occupied(write);
+                }
+                on_object(read, write);
+                ++write;
+            }
+            if (write != end)
+            {
+                invalidate_cache();
+            }
+            return write;
+        }
+
+        void mark_occupied(size_type index) noexcept
+        {
+            std::uint64_t& word = occupied_bits_[index / 64];
+            word |= std::uint64_t{1} << (index % 64);
+            if (word == ~std::uint64_t{0})
+            {
+                const size_type w = index / 64;
+                full_words_[w / 64] |= std::uint64_t{1} << (w % 64);
+            }
+            occupied_end_ = std::max(occupied_end_, index + 1);
+            ++occupied_count_;
+            types_.insert(index, slots_[index].ops);
+            mark_dirty(index);
+        }
+
+        void mark_dirty(size_type index) noexcept
+        {
+            dirty_bits_[index / 64] |= std::uint64_t{1} << (index % 64);
+        }
+
+        void mark_free(size_type index) noexcept
+        {
+            const size_type w = index / 64;
+            full_words_[w / 64] &= ~(std::uint64_t{1} << (w % 64));
+            occupied_bits_[w] &= ~(std::uint64_t{1} << (index % 64));
+            types_.erase(index);
+            mark_dirty(index);
+            while (occupied_end_ > 0 && slots_[occupied_end_ - 1].ptr == nullptr)
+            {
+                --occupied_end_;
+            }
+            --occupied_count_;
+        }
+
+        // Lowest free slot or npos
+        size_type find_free() const noexcept
+        {
+            for (size_type s = 0; s < full_words_.size(); ++s)
+            {
+                if (full_words_[s] == ~std::uint64_t{0})
+                {
+                    continue;
+                }
+                const size_type w = s * 64 + std::countr_one(full_words_[s]);
+                if (w >= bitmap_words)
+                {
+                    return npos;
+                }
+                const size_type index =
+                    w * 64 + std::countr_one(occupied_bits_[w]);
+                return index < N ? index : npos;
+            }
+            return npos;
+        }
+
+        bool element_equal(size_type index, const poly_array& other) const
+        {
+            const slot_info& mine   = slots_[index];
+            const slot_info& theirs = other.slots_[index];
+            if (!mine.ptr || !theirs.ptr)
+            {
+                return !mine.ptr && !theirs.ptr;
+            }
+            return safe_equal(get_storage_slot(index), *mine.ops,
+                              other.get_storage_slot(index), *theirs.ops);
+        }
+
+        // Pointer cache for iterator support (fixed-size array avoids std::vector
+        // template issues)
+        mutable std::array<Base*, N> ptr_cache_{};
+        mutable bool                 cache_valid_ = false;
+
+        void update_ptr_cache() const
+        {
+            if (!cache_valid_)
+            {
+                [[maybe_unused]] trace_scope span("poly_array::rebuild_cache", N);
+                for (size_t i = 0; i < N; ++i)
+                {
+                    ptr_cache_[i] = slots_[i].ptr;
+                }
+                cache_valid_ = true;
+            }
+        }
+
+        void invalidate_cache() const noexcept
+        {
+            cache_valid_ = false;
+        }
+
+        void* get_storage_slot(size_t index) noexcept
+        {
+            return &storage_[index * SlotSize];
+        }
+
+        const void* get_storage_slot(size_t index) const noexcept
+        {
+            return &storage_[index * SlotSize];
+        }
+
+        void destroy_at(size_type index) noexcept
+        {
+            if (slots_[index].ptr && slots_[index].ops)
+            {
+                safe_destroy(slots_[index].ptr, *slots_[index].ops);
+                slots_[index] = {};
+                mark_free(index);
+            }
+        }
 
         void copy_from(const poly_array& other)
         {
+            [[maybe_unused]] trace_scope span("poly_array::copy", N);
             for (size_type i = 0; i < N; ++i)
             {
                 if (other.slots_[i].ptr && other.slots_[i].ops)
@@ -563,6 +1457,7 @@ namespace inline_poly
 
                     slots_[i] = {.ptr = static_cast<Base*>(dst),
                                  .ops = other.slots_[i].ops};
+                    mark_occupied(i);
                 }
             }
             can_copy_ = other.can_copy_;
@@ -571,6 +1466,7 @@ namespace inline_poly
 
         void move_from(poly_array&& other) noexcept
         {
+            [[maybe_unused]] trace_scope span("poly_array::move", N);
             for (size_type i = 0; i < N; ++i)
             {
                 if (other.slots_[i].ptr && other.slots_[i].ops)
@@ -582,6 +1478,7 @@ namespace inline_poly
 
                     slots_[i] = {.ptr = static_cast<Base*>(dst),
                                  .ops = other.slots_[i].ops};
+                    mark_occupied(i);
 
                     // Clean up source
                     other.destroy_at(i);
@@ -593,6 +1490,8 @@ namespace inline_poly
 
         void update_capabilities()
         {
+            [[maybe_unused]] trace_scope span("poly_array::update_capabilities",
+                                              N);
             bool all_copyable = true;
             bool all_movable  = true;
             bool has_elements = false;
@@ -621,9 +1520,14 @@ namespace inline_poly
     // --- Unified Vector Container ---
 
     template <PolymorphicBase Base, size_t Capacity,
-              size_t SlotSize = sizeof(Base), size_t Alignment = alignof(Base)>
+              size_t SlotSize = sizeof(Base), size_t Alignment = alignof(Base),
+              typename Policy = default_policy>
     class poly_vector
     {
+        // insert_range() reads the slots of vectors with other parameters
+        template <PolymorphicBase, size_t, size_t, size_t, typename>
+        friend class poly_vector;
+
     public:
         // Typedefs for STL compatibility
         using value_type      = Base*;
@@ -747,6 +1651,10 @@ namespace inline_poly
                       "Alignment must be at least alignof(Base)");
 
     private:
+        using trace_scope = typename Policy::trace::scope;
+        using type_index =
+            detail::type_slot_index<typename Policy::indexed_types, Capacity>;
+
         // Storage for objects and their type information
         struct slot_info
         {
@@ -760,6 +1668,17 @@ namespace inline_poly
         bool                            can_copy_ = false;
         bool                            can_move_ = true;
 
+        // Tombstones left by erase_deferred(), one bit per slot
+        std::array<std::uint64_t, (Capacity + 63) / 64> erased_bits_{};
+        size_t                                          erased_count_ = 0;
+
+        // Slots left to step() by begin_incremental_clear(); they may still
+        // hold objects and always lie at or behind size_
+        size_t pending_begin_ = 0;
+        size_t pending_end_   = 0;
+
+        [[no_unique_address]] type_index types_;
+
         // Pointer cache for iterator support (fixed-size array avoids std::vector
         // template issues)
         mutable std::array<Base*, Capacity> ptr_cache_{};
@@ -831,6 +1750,8 @@ namespace inline_poly
                     "poly_vector::emplace_back() - capacity exceeded");
             }
 
+            reclaim_through(size_ + 1);
+
             // Get type operations
             const auto& ops = get_type_ops<Derived>();
 
@@ -841,6 +1762,7 @@ namespace inline_poly
 
             // Update slot info
             slots_[size_] = {.ptr = new_obj, .ops = &ops};
+            types_.insert(size_, &ops);
 
             ++size_;
             cache_valid_ = false;
@@ -886,6 +1808,8 @@ namespace inline_poly
                     "poly_vector::emplace() - capacity exceeded");
             }
 
+            reclaim_through(size_ + 1);
+
             // Shift elements to make room (type-safe)
             if (index < size_)
             {
@@ -901,6 +1825,7 @@ namespace inline_poly
                 new (placement_ptr) Derived(std::forward<Args>(args)...);
 
             slots_[index] = {.ptr = new_obj, .ops = &ops};
+            types_.insert(index, &ops);
 
             ++size_;
             cache_valid_ = false;
@@ -910,6 +1835,124 @@ namespace inline_poly
             return iterator(&ptr_cache_[index]);
         }
 
+        // Construct count objects of type Derived from the same args before
+        // pos, shifting the tail once by count. If a constructor throws,
+        // the objects constructed so far are kept.
+        template <typename Derived, typename... Args>
+            requires FitsInSlot<Derived, Base, SlotSize, Alignment> &&
+                     std::constructible_from<Derived, const Args&...>
+        iterator emplace_n(iterator pos, size_type count, const Args&... args)
+        {
+            const auto&  ops   = get_type_ops<Derived>();
+            const size_t index = open_gap(pos, count, "emplace_n");
+            fill_gap(index, count,
+                     [&](size_t slot)
+                     {
+                         void* dst = get_storage_slot(slot);
+                         slots_[slot] = {.ptr = new (dst) Derived(args...),
+                                         .ops = &ops};
+                     });
+            update_ptr_cache();
+            return iterator(&ptr_cache_[index]);
+        }
+
+        // Copy the elements [first, last) of other (which may be this
+        // vector) before pos, shifting the tail once. Erased source slots
+        // are inserted as tombstones. Throws
+        // std::invalid_argument before anything is changed if an element
+        // does not fit this vector's slots.
+        template <size_t C2, size_t S2, size_t A2, typename P2>
+        iterator insert_range(iterator pos,
+                              const poly_vector<Base, C2, S2, A2, P2>& other,
+                              size_type first, size_type last)
+        {
+            if (first > last || last > other.size())
+            {
+                throw std::out_of_range(
+                    "poly_vector::insert_range() - invalid source range");
+            }
+            check_fits(other, first, last);
+
+            const size_type count = last - first;
+            const size_t    index = open_gap(pos, count, "insert_range");
+
+            // Copying from this vector reads the elements at their shifted
+            // positions
+            const auto source = [&](size_t i)
+            {
+                if constexpr (std::is_same_v<decltype(other), const poly_vector&>)
+                {
+                    if (&other == this && i >= index)
+                    {
+                        return i + count;
+                    }
+                }
+                return i;
+            };
+            fill_gap(index, count,
+                     [&](size_t slot)
+                     {
+                         const size_t src = source(first + (slot - index));
+                         const auto&  info = other.slots_[src];
+                         if (info.ptr)
+                         {
+                             void* dst = get_storage_slot(slot);
+                             safe_copy_construct(dst,
+                                                 other.get_storage_slot(src),
+                                                 *info.ops);
+                             slots_[slot] = {.ptr = static_cast<Base*>(dst),
+                                             .ops = info.ops};
+                         }
+                         else if (other.is_erased(src))
+                         {
+                             add_tombstone(slot);
+                         }
+                     });
+            update_ptr_cache();
+            return iterator(&ptr_cache_[index]);
+        }
+
+        // Relocate all elements of other before pos, shifting the tail once,
+        // and leave other empty. Erased source slots stay tombstones.
+        template <size_t C2, size_t S2, size_t A2, typename P2>
+        iterator insert_range(iterator                               pos,
+                              poly_vector<Base, C2, S2, A2, P2>&& other)
+        {
+            if constexpr (std::is_same_v<decltype(other), poly_vector&&>)
+            {
+                if (&other == this)
+                {
+                    throw std::invalid_argument(
+                        "poly_vector::insert_range() - cannot move from self");
+                }
+            }
+            check_fits(other, 0, other.size());
+
+            const size_type count = other.size();
+            const size_t    index = open_gap(pos, count, "insert_range");
+            fill_gap(index, count,
+                     [&](size_t slot)
+                     {
+                         const size_t src  = slot - index;
+                         const auto&  info = other.slots_[src];
+                         if (info.ptr)
+                         {
+                             void* dst = get_storage_slot(slot);
+                             safe_move_construct(dst, other.get_storage_slot(src),
+                                                 *info.ops);
+                             slots_[slot] = {.ptr = static_cast<Base*>(dst),
+                                             .ops = info.ops};
+                         }
+                         else if (other.is_erased(src))
+                         {
+                             add_tombstone(slot);
+                         }
+                     });
+            other.clear();
+            update_ptr_cache();
+            return iterator(&ptr_cache_[index]);
+        }
+
         void pop_back()
         {
             if (size_ == 0)
@@ -920,6 +1963,7 @@ namespace inline_poly
 
             --size_;
             destroy_at(size_);
+            forget_tombstone(size_);
             cache_valid_ = false;
             update_capabilities();
         }
@@ -967,10 +2011,14 @@ namespace inline_poly
                     "to remove elements from the end.");
             }
 
+            [[maybe_unused]] trace_scope span("poly_vector::erase",
+                                              size_ - first_index);
+
             // Destroy elements in range
             for (size_t i = first_index; i < last_index; ++i)
             {
                 destroy_at(i);
+                forget_tombstone(i);
             }
 
             // Shift remaining elements left (type-safe)
@@ -989,14 +2037,255 @@ namespace inline_poly
 
         void clear() noexcept
         {
+            [[maybe_unused]] trace_scope span("poly_vector::clear", size_);
             for (size_t i = 0; i < size_; ++i)
             {
                 destroy_at(i);
             }
-            size_        = 0;
-            can_copy_    = false;
-            can_move_    = true;
+            size_         = 0;
+            erased_bits_  = {};
+            erased_count_ = 0;
+            can_copy_     = false;
+            can_move_     = true;
+            cache_valid_  = false;
+            reclaim_through(pending_end_);
+        }
+
+        // --- Incremental Clear ---
+
+        // Empty the vector in O(1) and leave the destruction of its elements
+        // to step(), so clearing a large vector can be spread over several
+        // frames. The vector reads as empty immediately. New elements reuse
+        // reclaimed slots; a slot that is still pending is destroyed when it
+        // is needed. clear() and the destructor finish all pending work.
+        void begin_incremental_clear() noexcept
+        {
+            pending_begin_ = 0;
+            pending_end_   = std::max(pending_end_, size_);
+            size_          = 0;
+            erased_bits_   = {};
+            erased_count_  = 0;
+            can_copy_      = false;
+            can_move_      = true;
+            cache_valid_   = false;
+            types_.clear();
+        }
+
+        // Destroy up to max_elements pending slots; returns the number of
+        // slots still pending
+        size_type step(size_type max_elements) noexcept
+        {
+            [[maybe_unused]] trace_scope span("poly_vector::clear_step",
+                                              max_elements);
+            reclaim_through(pending_begin_ +
+                            std::min(max_elements, pending_destruction()));
+            return pending_destruction();
+        }
+
+        // Destroy pending slots until the time budget is used up; the clock
+        // is read after every element, so one destructor may overrun the
+        // budget. Returns the number of slots still pending.
+        template <typename Rep, typename Period>
+        size_type step(std::chrono::duration<Rep, Period> budget) noexcept
+        {
+            [[maybe_unused]] trace_scope span("poly_vector::clear_step",
+                                              pending_destruction());
+            const auto deadline = std::chrono::steady_clock::now() + budget;
+            while (pending_destruction() > 0)
+            {
+                reclaim_through(pending_begin_ + 1);
+                if (std::chrono::steady_clock::now() >= deadline)
+                {
+                    break;
+                }
+            }
+            return pending_destruction();
+        }
+
+        // Slots whose objects begin_incremental_clear() has not destroyed yet
+        [[nodiscard]] size_type pending_destruction() const noexcept
+        {
+            return pending_end_ - pending_begin_;
+        }
+
+        // --- Deferred Erase ---
+
+        // Destroy the element at index and leave a tombstone instead of
+        // shifting the elements behind it, so a burst of erasures costs no
+        // relocations. The slot reads as nullptr, live() skips it, and
+        // compact() closes all holes in one pass. If the policy sets a
+        // tombstone_compaction_ratio, reaching it compacts immediately,
+        // which invalidates indices. Only erasing a non-copyable or
+        // non-movable element rescans the capabilities.
+        void erase_deferred(size_type index)
+        {
+            if (index >= size_)
+            {
+                throw std::out_of_range(
+                    "poly_vector::erase_deferred() - index out of bounds");
+            }
+            if (is_erased(index))
+            {
+                throw std::logic_error(
+                    "poly_vector::erase_deferred() - element already erased");
+            }
+
+            const type_operations* ops = slots_[index].ops;
+            destroy_at(index);
+            add_tombstone(index);
             cache_valid_ = false;
+            if (erased_count_ == size_)
+            {
+                can_copy_ = true;
+                can_move_ = true;
+            }
+            else if (ops && (!ops->is_copy_constructible ||
+                             !ops->is_move_constructible))
+            {
+                update_capabilities();
+            }
+
+            constexpr double ratio = Policy::tombstone_compaction_ratio;
+            if (ratio > 0.0 && can_move_ &&
+                static_cast<double>(erased_count_) >=
+                    ratio * static_cast<double>(size_))
+            {
+                compact();
+            }
+        }
+
+        // Remove all tombstones in a single relocation pass; the remaining
+        // elements keep their order
+        void compact()
+        {
+            if (erased_count_ == 0)
+            {
+                return;
+            }
+            if (!can_move_)
+            {
+                throw std::runtime_error(
+                    "poly_vector::compact() - cannot move elements: contained "
+                    "types are neither movable nor copyable.");
+            }
+
+            [[maybe_unused]] trace_scope span("poly_vector::compact", size_);
+            size_t write = 0;
+            for (size_t read = next_live(0); read < size_;
+                 read        = next_live(read + 1))
+            {
+                if (read != write)
+                {
+                    relocate_slot(write, read);
+                }
+                ++write;
+            }
+            size_         = write;
+            erased_bits_  = {};
+            erased_count_ = 0;
+            cache_valid_  = false;
+        }
+
+        // Destroy every element for which pred(Base*) returns true and close
+        // the gaps in one stable pass: each survivor is relocated once, runs
+        // of trivially relocatable survivors with a single memmove, and the
+        // capabilities and iterator cache are updated once at the end.
+        // Tombstones are removed as well; empty slots left by resize() are
+        // passed to pred as nullptr. Returns the number of elements removed.
+        template <typename Pred>
+        friend size_type erase_if(poly_vector& vec, Pred pred)
+        {
+            return vec.erase_matching(pred);
+        }
+
+        [[nodiscard]] bool is_erased(size_type index) const noexcept
+        {
+            return (erased_bits_[index / 64] >> (index % 64)) & 1u;
+        }
+
+        // Number of tombstones among the size() slots
+        [[nodiscard]] size_type erased_count() const noexcept
+        {
+            return erased_count_;
+        }
+
+        // Forward range over the elements that have not been erased
+        template <typename Vector, typename Pointer>
+        class basic_live_view
+        {
+        public:
+            class iterator
+            {
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type        = Pointer;
+                using difference_type   = std::ptrdiff_t;
+                using pointer           = void;
+                using reference         = Pointer;
+
+                iterator() = default;
+                iterator(Vector* vec, size_t index) : vec_(vec), index_(index)
+                {}
+
+                reference operator*() const
+                {
+                    return vec_->slots_[index_].ptr;
+                }
+                iterator& operator++()
+                {
+                    index_ = vec_->next_live(index_ + 1);
+                    return *this;
+                }
+                iterator operator++(int)
+                {
+                    iterator tmp = *this;
+                    ++*this;
+                    return tmp;
+                }
+                // Position of the element in the vector
+                [[nodiscard]] size_t index() const noexcept
+                {
+                    return index_;
+                }
+                bool operator==(const iterator& other) const
+                {
+                    return index_ == other.index_;
+                }
+
+            private:
+                Vector* vec_   = nullptr;
+                size_t  index_ = 0;
+            };
+
+            explicit basic_live_view(Vector& vec) : vec_(&vec) {}
+
+            iterator begin() const
+            {
+                return iterator(vec_, vec_->next_live(0));
+            }
+            iterator end() const
+            {
+                return iterator(vec_, vec_->size_);
+            }
+            [[nodiscard]] size_type size() const noexcept
+            {
+                return vec_->size_ - vec_->erased_count_;
+            }
+
+        private:
+            Vector* vec_;
+        };
+
+        using live_view       = basic_live_view<poly_vector, Base*>;
+        using const_live_view = basic_live_view<const poly_vector, const Base*>;
+
+        [[nodiscard]] live_view live() noexcept
+        {
+            return live_view(*this);
+        }
+        [[nodiscard]] const_live_view live() const noexcept
+        {
+            return const_live_view(*this);
         }
 
         void resize(size_type new_size)
@@ -1012,6 +2301,7 @@ namespace inline_poly
                 pop_back();
             }
 
+            reclaim_through(new_size);
             while (size_ < new_size)
             {
                 slots_[size_].ptr = nullptr;
@@ -1202,7 +2492,378 @@ namespace inline_poly
             return can_move_;
         }
 
+        // --- Per-Type Index ---
+
+        // Indices of the slots holding exactly a T, in ascending order. T
+        // must be listed in the policy's indexed_types; the index is kept up
+        // to date by every modifier, so this costs one word per 64 slots
+        // plus the matches instead of a type check per element.
+        template <typename T>
+            requires type_index::template contains<T>
+        [[nodiscard]] typename type_index::view indices_of() const noexcept
+        {
+            return types_.template indices_of<T>();
+        }
+
+        // Call fn(T&) for every element of exact type T, in index order
+        template <typename T, typename Fn>
+            requires type_index::template contains<T>
+        void for_each(Fn&& fn)
+        {
+            for (const size_type i : indices_of<T>())
+            {
+                fn(static_cast<T&>(*slots_[i].ptr));
+            }
+        }
+        template <typename T, typename Fn>
+            requires type_index::template contains<T>
+        void for_each(Fn&& fn) const
+        {
+            for (const size_type i : indices_of<T>())
+            {
+                fn(static_cast<const T&>(*slots_[i].ptr));
+            }
+        }
+
+        // --- Comparison ---
+
+        // Element-wise equality through the stored types' equal operations.
+        // Elements of different types compare unequal without calling into
+        // either type. Throws std::logic_error if two objects of a type
+        // without equality have to be compared.
+        friend bool operator==(const poly_vector& lhs, const poly_vector& rhs)
+        {
+            if (lhs.size_ != rhs.size_)
+            {
+                return false;
+            }
+            for (size_type i = 0; i < lhs.size_; ++i)
+            {
+                if (!lhs.element_equal(i, rhs))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Hash of all elements in order; throws std::logic_error if a stored
+        // type has no hash function
+        [[nodiscard]] std::size_t hash() const
+        {
+            std::size_t seed = size_;
+            for (size_type i = 0; i < size_; ++i)
+            {
+                const std::size_t value =
+                    slots_[i].ptr
+                        ? safe_hash(get_storage_slot(i), *slots_[i].ops)
+                        : 0;
+                seed = detail::hash_combine(seed, value);
+            }
+            return seed;
+        }
+
+        // Write the indices at which lhs and rhs differ to out; positions
+        // present in only one of them count as changed
+        template <typename OutputIt>
+        friend OutputIt diff(const poly_vector& lhs, const poly_vector& rhs,
+                             OutputIt out)
+        {
+            const size_type common = std::min(lhs.size_, rhs.size_);
+            const size_type total  = std::max(lhs.size_, rhs.size_);
+            for (size_type i = 0; i < total; ++i)
+            {
+                if (i >= common || !lhs.element_equal(i, rhs))
+                {
+                    *out = i;
+                    ++out;
+                }
+            }
+            return out;
+        }
+
     private:
+        bool element_equal(size_type index, const poly_vector& other) const
+        {
+            const slot_info& mine   = slots_[index];
+            const slot_info& theirs = other.slots_[index];
+            if (!mine.ptr || !theirs.ptr)
+            {
+                return !mine.ptr && !theirs.ptr;
+            }
+            return safe_equal(get_storage_slot(index), *mine.ops,
+                              other.get_storage_slot(index), *theirs.ops);
+        }
+
+        // First index >= index without a tombstone, or size_
+        size_t next_live(size_t index) const noexcept
+        {
+            while (index < size_)
+            {
+                const size_t        bit  = index % 64;
+                const std::uint64_t live = ~erased_bits_[index / 64] >> bit;
+                if (live != 0)
+                {
+                    return std::min(
+                        index + static_cast<size_t>(std::countr_zero(live)),
+                        size_);
+                }
+                index += 64 - bit;
+            }
+            return size_;
+        }
+
+        void add_tombstone(size_t index) noexcept
+        {
+            erased_bits_[index / 64] |= std::uint64_t{1} << (index % 64);
+            ++erased_count_;
+        }
+
+        void forget_tombstone(size_t index) noexcept
+        {
+            if (is_erased(index))
+            {
+                erased_bits_[index / 64] &= ~(std::uint64_t{1} << (index % 64));
+                --erased_count_;
+            }
+        }
+
+        template <typename Pred>
+        size_type erase_matching(Pred& pred)
+        {
+            if (!can_move_)
+            {
+                throw std::runtime_error(
+                    "poly_vector::erase_if() - cannot move elements: contained "
+                    "types are neither movable nor copyable.");
+            }
+
+            [[maybe_unused]] trace_scope span("poly_vector::erase_if", size_);
+            size_t removed   = 0;
+            size_t write     = 0;
+            size_t read      = 0;
+            size_t run_begin = 0; // Survivors [run_begin, run_begin + run_size)
+            size_t run_dst   = 0; // move to [run_dst, run_dst + run_size)
+            size_t run_size  = 0;
+
+            const auto flush_run = [&]
+            {
+                move_block(run_dst, run_begin, run_size);
+                run_size = 0;
+            };
+
+            try
+            {
+                for (; read < size_; ++read)
+                {
+                    if (is_erased(read))
+                    {
+                        forget_tombstone(read);
+                        continue;
+                    }
+                    if (pred(slots_[read].ptr))
+                    {
+                        destroy_at(read);
+                        ++removed;
+                        continue;
+                    }
+
+                    const type_operations* ops = slots_[read].ops;
+                    if (!ops || ops->is_trivially_copyable ||
+                        ops->is_trivially_relocatable)
+                    {
+                        if (run_size == 0 || run_begin + run_size != read)
+                        {
+                            flush_run();
+                            run_begin = read;
+                            run_dst   = write;
+                        }
+                        ++run_size;
+                    }
+                    else
+                    {
+                        flush_run();
+                        if (read != write)
+                        {
+                            relocate_slot(write, read);
+                        }
+                    }
+                    ++write;
+                }
+                flush_run();
+            }
+            catch (...)
+            {
+                // Keep the unvisited elements, closing the gaps in front of
+                // them
+                flush_run();
+                for (; read < size_; ++read, ++write)
+                {
+                    if (read != write)
+                    {
+                        relocate_slot(write, read);
+                    }
+                }
+                size_        = write;
+                cache_valid_ = false;
+                update_capabilities();
+                throw;
+            }
+
+            size_        = write;
+            cache_valid_ = false;
+            update_capabilities();
+            return removed;
+        }
+
+        // Relocate count trivially relocatable elements (or empty slots) from
+        // src to dst <= src with one memmove of their storage
+        void move_block(size_t dst, size_t src, size_t count) noexcept
+        {
+            if (count == 0 || dst == src)
+            {
+                return;
+            }
+            std::memmove(get_storage_slot(dst), get_storage_slot(src),
+                         count * SlotSize);
+            const std::ptrdiff_t offset =
+                static_cast<std::ptrdiff_t>((src - dst) * SlotSize);
+            for (size_t k = 0; k < count; ++k)
+            {
+                slot_info slot = slots_[src + k];
+                if (slot.ptr)
+                {
+                    slot.ptr = std::launder(reinterpret_cast<Base*>(
+                        reinterpret_cast<std::byte*>(slot.ptr) - offset));
+                    types_.move(dst + k, src + k);
+                }
+                slots_[src + k] = {};
+                slots_[dst + k] = slot;
+            }
+        }
+
+        // Shift the elements from pos on right by count in one pass and
+        // return the index of the first of the count empty slots
+        size_t open_gap(iterator pos, size_type count, const char* fn)
+        {
+            update_ptr_cache();
+            const size_t index =
+                static_cast<size_t>(pos - iterator(ptr_cache_.data()));
+            if (index > size_)
+            {
+                throw std::out_of_range(
+                    std::format("poly_vector::{}() - invalid position", fn));
+            }
+            if (count > Capacity - size_)
+            {
+                throw std::out_of_range(
+                    std::format("poly_vector::{}() - capacity exceeded", fn));
+            }
+            if (count == 0)
+            {
+                return index;
+            }
+
+            reclaim_through(size_ + count);
+            if (index < size_)
+            {
+                shift_right(index, count);
+            }
+            size_        += count;
+            cache_valid_  = false;
+            return index;
+        }
+
+        // Call construct(slot) for each slot of the gap [index, index + count)
+        // opened by open_gap(). If it throws, the rest of the gap is closed
+        // again before the exception propagates.
+        template <typename Fn>
+        void fill_gap(size_t index, size_type count, Fn&& construct)
+        {
+            size_t filled = 0;
+            try
+            {
+                for (; filled < count; ++filled)
+                {
+                    construct(index + filled);
+                    if (slots_[index + filled].ptr)
+                    {
+                        types_.insert(index + filled, slots_[index + filled].ops);
+                    }
+                }
+            }
+            catch (...)
+            {
+                const size_t unfilled = count - filled;
+                shift_left(index + count, unfilled);
+                size_       -= unfilled;
+                cache_valid_ = false;
+                update_capabilities();
+                throw;
+            }
+            update_capabilities();
+        }
+
+        // Throw unless every element of other in [first, last) fits a slot
+        template <typename Other>
+        static void check_fits(const Other& other, size_t first, size_t last)
+        {
+            for (size_t i = first; i < last; ++i)
+            {
+                const type_operations* ops = other.slots_[i].ops;
+                if (ops && (ops->size > SlotSize || ops->alignment > Alignment))
+                {
+                    throw std::invalid_argument(
+                        "poly_vector::insert_range() - element does not fit "
+                        "the slots");
+                }
+            }
+        }
+
+        // Destroy the pending objects in front of slot index end
+        void reclaim_through(size_t end) noexcept
+        {
+            end = std::min(end, pending_end_);
+            while (pending_begin_ < end)
+            {
+                destroy_at(pending_begin_);
+                ++pending_begin_;
+            }
+            if (pending_begin_ == pending_end_)
+            {
+                pending_begin_ = 0;
+                pending_end_   = 0;
+            }
+        }
+
+        // Move the element (or empty slot) at src into the empty slot dst,
+        // together with its tombstone bit
+        void relocate_slot(size_t dst, size_t src)
+        {
+            if (slots_[src].ptr && slots_[src].ops)
+            {
+                void* dst_storage = get_storage_slot(dst);
+                void* src_storage = get_storage_slot(src);
+
+                // Move to the new location and destroy the old object
+                safe_relocate(dst_storage, src_storage, *slots_[src].ops);
+
+                // Update slot info
+                slots_[dst]     = slots_[src];
+                slots_[dst].ptr = static_cast<Base*>(dst_storage);
+                slots_[src]     = {};
+                types_.move(dst, src);
+            }
+
+            const bool erased = is_erased(src);
+            forget_tombstone(src);
+            if (erased)
+            {
+                erased_bits_[dst / 64] |= std::uint64_t{1} << (dst % 64);
+                ++erased_count_;
+            }
+        }
+
         void* get_storage_slot(size_t index) noexcept
         {
             return &storage_[index * SlotSize];
@@ -1219,35 +2880,20 @@ namespace inline_poly
             {
                 safe_destroy(slots_[index].ptr, *slots_[index].ops);
                 slots_[index] = {};
+                types_.erase(index);
             }
         }
 
         // Type-safe shift operations that properly move objects
         void shift_right(size_t start_index, size_t count)
         {
+            [[maybe_unused]] trace_scope span("poly_vector::shift_right",
+                                              size_ - start_index);
             // Move objects from end to start
             for (size_t i = size_; i > start_index; --i)
             {
                 size_t src = i - 1;
-                size_t dst = src + count;
-
-                if (slots_[src].ptr && slots_[src].ops)
-                {
-                    void* dst_storage = get_storage_slot(dst);
-                    void* src_storage = get_storage_slot(src);
-
-                    // Move construct at new location
-                    safe_move_construct(dst_storage, src_storage,
-                                        *slots_[src].ops);
-
-                    // Update slot info
-                    slots_[dst]     = slots_[src];
-                    slots_[dst].ptr = static_cast<Base*>(dst_storage);
-
-                    // Destroy at old location
-                    safe_destroy(src_storage, *slots_[src].ops);
-                    slots_[src] = {};
-                }
+                relocate_slot(src + count, src);
             }
         }
 
@@ -1256,29 +2902,13 @@ namespace inline_poly
             // Move objects from start to end
             for (size_t i = start_index; i < size_; ++i)
             {
-                size_t dst = i - count;
-
-                if (slots_[i].ptr && slots_[i].ops)
-                {
-                    void* dst_storage = get_storage_slot(dst);
-                    void* src_storage = get_storage_slot(i);
-
-                    // Move construct at new location
-                    safe_move_construct(dst_storage, src_storage, *slots_[i].ops);
-
-                    // Update slot info
-                    slots_[dst]     = slots_[i];
-                    slots_[dst].ptr = static_cast<Base*>(dst_storage);
-
-                    // Destroy at old location
-                    safe_destroy(src_storage, *slots_[i].ops);
-                    slots_[i] = {};
-                }
+                relocate_slot(i - count, i);
             }
         }
 
         void copy_from(const poly_vector& other)
         {
+            [[maybe_unused]] trace_scope span("poly_vector::copy", other.size_);
             size_ = other.size_;
             for (size_type i = 0; i < size_; ++i)
             {
@@ -1291,15 +2921,19 @@ namespace inline_poly
 
                     slots_[i] = {.ptr = static_cast<Base*>(dst),
                                  .ops = other.slots_[i].ops};
+                    types_.insert(i, slots_[i].ops);
                 }
             }
-            can_copy_    = other.can_copy_;
-            can_move_    = other.can_move_;
-            cache_valid_ = false;
+            erased_bits_  = other.erased_bits_;
+            erased_count_ = other.erased_count_;
+            can_copy_     = other.can_copy_;
+            can_move_     = other.can_move_;
+            cache_valid_  = false;
         }
 
         void move_from(poly_vector&& other) noexcept
         {
+            [[maybe_unused]] trace_scope span("poly_vector::move", other.size_);
             size_ = other.size_;
             for (size_type i = 0; i < size_; ++i)
             {
@@ -1312,19 +2946,26 @@ namespace inline_poly
 
                     slots_[i] = {.ptr = static_cast<Base*>(dst),
                                  .ops = other.slots_[i].ops};
+                    types_.insert(i, slots_[i].ops);
 
                     // Clean up source
                     other.destroy_at(i);
                 }
             }
-            can_copy_    = other.can_copy_;
-            can_move_    = other.can_move_;
-            other.size_  = 0;
-            cache_valid_ = false;
+            erased_bits_        = other.erased_bits_;
+            erased_count_       = other.erased_count_;
+            can_copy_           = other.can_copy_;
+            can_move_           = other.can_move_;
+            other.size_         = 0;
+            other.erased_bits_  = {};
+            other.erased_count_ = 0;
+            cache_valid_        = false;
         }
 
         void update_capabilities()
         {
+            [[maybe_unused]] trace_scope span(
+                "poly_vector::update_capabilities", size_);
             bool all_copyable = true;
             bool all_movable  = true;
             bool has_elements = false;
@@ -1353,6 +2994,8 @@ namespace inline_poly
         {
             if (!cache_valid_)
             {
+                [[maybe_unused]] trace_scope span("poly_vector::rebuild_cache",
+                                                  size_);
                 for (size_t i = 0; i < size_; ++i)
                 {
                     ptr_cache_[i] = slots_[i].ptr;
@@ -1369,12 +3012,14 @@ namespace inline_poly
 
     // Type aliases for cleaner API
     template <PolymorphicBase Base, size_t N, size_t SlotSize = sizeof(Base),
-              size_t Alignment = alignof(Base)>
-    using array = poly_array<Base, N, SlotSize, Alignment>;
+              size_t   Alignment = alignof(Base),
+              typename Policy    = default_policy>
+    using array = poly_array<Base, N, SlotSize, Alignment, Policy>;
 
     template <PolymorphicBase Base, size_t Capacity,
-              size_t SlotSize = sizeof(Base), size_t Alignment = alignof(Base)>
-    using vector = poly_vector<Base, Capacity, SlotSize, Alignment>;
+              size_t SlotSize = sizeof(Base), size_t Alignment = alignof(Base),
+              typename Policy = default_policy>
+    using vector = poly_vector<Base, Capacity, SlotSize, Alignment, Policy>;
 
 } // namespace inline_poly
 
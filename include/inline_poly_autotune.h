@@ -0,0 +1,453 @@
+// Copyright 2025 Dr. Matthias Hölzl
+
+// inline_poly_autotune.h - Slot configuration recommendations from observed
+// type histograms
+//
+// Sizing every slot by max_size_v<TypeList> wastes memory when one type is
+// large but rare. Given how often each registered type actually occurs (counted
+// at runtime from containers, or entered by hand from a trace), the autotuner
+// projects the storage cost of three layouts and recommends one:
+//   - single_slot:  one slot size for everything (what poly_vector does today)
+//   - size_classes: two or three pools with different slot sizes
+//   - overflow:     a smaller inline slot, rare large types spill to the heap
+
+#pragma once
+#ifndef INLINE_POLY_AUTOTUNE_H
+#define INLINE_POLY_AUTOTUNE_H
+
+#include "inline_poly.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <typeinfo>
+
+namespace inline_poly
+{
+
+    // =============================================================================
+    // Type Histograms
+    // =============================================================================
+
+    // Size, alignment and observed frequency of one concrete type
+    struct type_footprint
+    {
+        const char*   name      = "";
+        std::size_t   size      = 0;
+        std::size_t   alignment = 1;
+        std::uint64_t count     = 0;
+    };
+
+    // Histogram over the types of a type_list. Counts are gathered by
+    // observing containers (dynamic type via typeid) or added explicitly.
+    template <typename TypeList>
+    class type_histogram;
+
+    template <typename... Types>
+    class type_histogram<type_list<Types...>>
+    {
+    public:
+        static constexpr std::size_t type_count = sizeof...(Types);
+
+        type_histogram() noexcept :
+            entries_{type_footprint{.name      = typeid(Types).name(),
+                                    .size      = sizeof(Types),
+                                    .alignment = alignof(Types),
+                                    .count     = 0}...}
+        {}
+
+        // Count every non-null element of a container (any range of Base*)
+        template <typename Container>
+        void observe(const Container& container)
+        {
+            for (const auto* element : container)
+            {
+                if (element != nullptr)
+                {
+                    add_dynamic(typeid(*element));
+                }
+            }
+        }
+
+        template <typename T>
+        void add(std::uint64_t n = 1) noexcept
+        {
+            entries_[index_of<T>()].count += n;
+        }
+
+        void add(std::size_t type_index, std::uint64_t n) noexcept
+        {
+            entries_[type_index].count += n;
+        }
+
+        void reset() noexcept
+        {
+            for (auto& entry : entries_)
+            {
+                entry.count = 0;
+            }
+        }
+
+        [[nodiscard]] std::span<const type_footprint> footprints() const noexcept
+        {
+            return entries_;
+        }
+
+        [[nodiscard]] std::uint64_t total() const noexcept
+        {
+            std::uint64_t sum = 0;
+            for (const auto& entry : entries_)
+            {
+                sum += entry.count;
+            }
+            return sum;
+        }
+
+        template <typename T>
+        static constexpr std::size_t index_of() noexcept
+        {
+            constexpr std::array<bool, type_count> matches = {
+                std::is_same_v<T, Types>...};
+            return static_cast<std::size_t>(
+                std::find(matches.begin(), matches.end(), true) -
+                matches.begin());
+        }
+
+    private:
+        void add_dynamic(const std::type_info& type) noexcept
+        {
+            const std::type_info* infos[] = {&typeid(Types)...};
+            for (std::size_t i = 0; i < type_count; ++i)
+            {
+                if (*infos[i] == type)
+                {
+                    ++entries_[i].count;
+                    return;
+                }
+            }
+        }
+
+        std::array<type_footprint, type_count> entries_;
+    };
+
+    // =============================================================================
+    // Recommendations
+    // =============================================================================
+
+    enum class slot_strategy
+    {
+        single_slot,
+        size_classes,
+        overflow
+    };
+
+    inline constexpr std::size_t max_size_classes = 3;
+
+    // One candidate layout and its projected cost for the observed histogram.
+    // Bytes count slot storage only; per-slot bookkeeping is the same for all
+    // strategies except the heap blocks of spilled elements.
+    struct slot_plan
+    {
+        slot_strategy strategy    = slot_strategy::single_slot;
+        std::size_t   class_count = 0;
+
+        // Ascending slot sizes/alignments and the number of elements per class.
+        // For overflow, class 0 is the inline slot.
+        std::array<std::size_t, max_size_classes>   slot_sizes{};
+        std::array<std::size_t, max_size_classes>   slot_alignments{};
+        std::array<std::uint64_t, max_size_classes> slot_counts{};
+
+        std::uint64_t overflow_count  = 0; // Elements spilled to the heap
+        std::uint64_t projected_bytes = 0; // Storage for all observed elements
+        std::uint64_t cache_lines     = 0; // Lines touched by one full pass
+    };
+
+    struct autotune_options
+    {
+        std::size_t cache_line_size = 64;
+        std::size_t max_classes     = max_size_classes; // 2 or 3
+        // Allocator header and rounding per heap block of a spilled element
+        std::size_t heap_overhead = 16;
+        // A simpler layout is preferred unless a more complex one saves more
+        // than this fraction of its bytes (single > size_classes > overflow)
+        double simplicity_margin = 0.10;
+    };
+
+    struct autotune_result
+    {
+        slot_plan recommended;
+        slot_plan single;
+        slot_plan split;
+        slot_plan overflow;
+    };
+
+    namespace detail
+    {
+        constexpr std::size_t round_up(std::size_t value,
+                                       std::size_t alignment) noexcept
+        {
+            return alignment ? (value + alignment - 1) / alignment * alignment
+                             : value;
+        }
+
+        // line must be positive; recommend_slots() checks it up front
+        constexpr std::uint64_t lines_for(std::uint64_t bytes,
+                                          std::size_t   line) noexcept
+        {
+            assert(line > 0);
+            return (bytes + line - 1) / line;
+        }
+
+        // Types sorted by size; classes are contiguous runs of this order
+        struct sorted_types
+        {
+            std::array<type_footprint, 64> items{};
+            std::size_t                    n = 0;
+        };
+
+        inline sorted_types sort_by_size(std::span<const type_footprint> types)
+        {
+            if (types.size() > sorted_types{}.items.size())
+            {
+                throw std::length_error(
+                    "recommend_slots() - at most 64 types are supported");
+            }
+            sorted_types sorted;
+            for (const auto& type : types)
+            {
+                sorted.items[sorted.n++] = type;
+            }
+            std::sort(sorted.items.begin(), sorted.items.begin() + sorted.n,
+                      [](const type_footprint& a, const type_footprint& b)
+                      { return a.size < b.size; });
+            return sorted;
+        }
+
+        // Slot for types [first, last] of the sorted list
+        struct class_slot
+        {
+            std::size_t   size      = 0;
+            std::size_t   alignment = 1;
+            std::uint64_t count     = 0;
+        };
+
+        inline class_slot slot_for(const sorted_types& sorted, std::size_t first,
+                                   std::size_t last)
+        {
+            class_slot slot;
+            for (std::size_t i = first; i <= last; ++i)
+            {
+                const auto& type = sorted.items[i];
+                slot.alignment   = std::max(slot.alignment, type.alignment);
+                slot.count      += type.count;
+            }
+            slot.size = round_up(sorted.items[last].size, slot.alignment);
+            return slot;
+        }
+
+        inline void add_class(slot_plan& plan, const class_slot& slot,
+                              std::size_t line)
+        {
+            const std::size_t c     = plan.class_count++;
+            plan.slot_sizes[c]      = slot.size;
+            plan.slot_alignments[c] = slot.alignment;
+            plan.slot_counts[c]     = slot.count;
+            plan.projected_bytes   += slot.count * slot.size;
+            plan.cache_lines       += lines_for(slot.count * slot.size, line);
+        }
+
+        inline slot_plan plan_single(const sorted_types&     sorted,
+                                     const autotune_options& options)
+        {
+            slot_plan plan{.strategy = slot_strategy::single_slot};
+            add_class(plan, slot_for(sorted, 0, sorted.n - 1),
+                      options.cache_line_size);
+            return plan;
+        }
+
+        // Partition the sorted types into at most max_classes contiguous runs
+        // minimizing total slot bytes (dynamic programming over split points)
+        inline slot_plan plan_split(const sorted_types&     sorted,
+                                    const autotune_options& options)
+        {
+            constexpr auto    inf = std::numeric_limits<std::uint64_t>::max();
+            const std::size_t n   = sorted.n;
+            const std::size_t k =
+                std::clamp<std::size_t>(options.max_classes, 1, max_size_classes);
+
+            // best[c][j]: cost of covering types [0, j) with c classes
+            using cost_row  = std::array<std::uint64_t, 65>;
+            using split_row = std::array<std::size_t, 65>;
+            std::array<cost_row, max_size_classes + 1>  best{};
+            std::array<split_row, max_size_classes + 1> split{};
+            for (auto& row : best)
+            {
+                row.fill(inf);
+            }
+            best[0][0] = 0;
+
+            for (std::size_t c = 1; c <= k; ++c)
+            {
+                for (std::size_t j = 1; j <= n; ++j)
+                {
+                    for (std::size_t i = c - 1; i < j; ++i)
+                    {
+                        if (best[c - 1][i] == inf)
+                        {
+                            continue;
+                        }
+                        const class_slot slot = slot_for(sorted, i, j - 1);
+                        const std::uint64_t cost =
+                            best[c - 1][i] + slot.count * slot.size;
+                        if (cost < best[c][j])
+                        {
+                            best[c][j]  = cost;
+                            split[c][j] = i;
+                        }
+                    }
+                }
+            }
+
+            // Fewest classes that reach the minimum. A class whose types were
+            // never observed keeps its zero count, so every type has a slot.
+            std::size_t classes = 1;
+            for (std::size_t c = 2; c <= k; ++c)
+            {
+                if (best[c][n] < best[classes][n])
+                {
+                    classes = c;
+                }
+            }
+
+            std::array<std::size_t, max_size_classes + 1> bounds{};
+            bounds[classes] = n;
+            for (std::size_t c = classes; c > 0; --c)
+            {
+                bounds[c - 1] = split[c][bounds[c]];
+            }
+
+            slot_plan plan{.strategy = slot_strategy::size_classes};
+            for (std::size_t c = 0; c < classes; ++c)
+            {
+                add_class(plan, slot_for(sorted, bounds[c], bounds[c + 1] - 1),
+                          options.cache_line_size);
+            }
+            return plan;
+        }
+
+        // Inline slot sized for a prefix of the sorted types; larger types
+        // keep a pointer in their inline slot and live in their own heap block
+        inline slot_plan plan_overflow(const sorted_types&     sorted,
+                                       const autotune_options& options)
+        {
+            const std::size_t line = options.cache_line_size;
+            slot_plan         best_plan;
+            bool              have_plan = false;
+
+            for (std::size_t last = 0; last < sorted.n; ++last)
+            {
+                class_slot inline_slot = slot_for(sorted, 0, last);
+                inline_slot.size = std::max(inline_slot.size, sizeof(void*));
+                inline_slot.alignment =
+                    std::max(inline_slot.alignment, alignof(void*));
+                inline_slot.size =
+                    round_up(inline_slot.size, inline_slot.alignment);
+
+                slot_plan plan{.strategy = slot_strategy::overflow};
+                std::uint64_t heap_bytes = 0;
+                std::uint64_t heap_lines = 0;
+                for (std::size_t i = last + 1; i < sorted.n; ++i)
+                {
+                    const auto&         type  = sorted.items[i];
+                    const std::uint64_t block = round_up(type.size, 16) +
+                                                options.heap_overhead;
+                    plan.overflow_count += type.count;
+                    heap_bytes          += type.count * block;
+                    heap_lines          += type.count * lines_for(block, line);
+                }
+
+                // Spilled elements also occupy an inline slot (their pointer)
+                inline_slot.count += plan.overflow_count;
+                add_class(plan, inline_slot, line);
+                plan.projected_bytes += heap_bytes;
+                plan.cache_lines     += heap_lines;
+
+                if (!have_plan ||
+                    plan.projected_bytes < best_plan.projected_bytes)
+                {
+                    best_plan = plan;
+                    have_plan = true;
+                }
+            }
+            return best_plan;
+        }
+    } // namespace detail
+
+    // Project the cost of each strategy for the observed histogram and pick
+    // the simplest one that is within the simplicity margin of the cheapest.
+    // Throws std::invalid_argument for an empty histogram or a zero cache
+    // line size.
+    inline autotune_result recommend_slots(std::span<const type_footprint> types,
+                                           const autotune_options& options = {})
+    {
+        if (types.empty())
+        {
+            throw std::invalid_argument("recommend_slots() - no types given");
+        }
+        if (options.cache_line_size == 0)
+        {
+            throw std::invalid_argument(
+                "recommend_slots() - cache_line_size must be positive");
+        }
+
+        const detail::sorted_types sorted = detail::sort_by_size(types);
+
+        autotune_result result;
+        result.single   = detail::plan_single(sorted, options);
+        result.split    = detail::plan_split(sorted, options);
+        result.overflow = detail::plan_overflow(sorted, options);
+
+        const auto within_margin = [&](const slot_plan& simple,
+                                       const slot_plan& complex)
+        {
+            return static_cast<double>(simple.projected_bytes) <=
+                   static_cast<double>(complex.projected_bytes) *
+                       (1.0 + options.simplicity_margin);
+        };
+
+        const slot_plan& cheaper_no_heap =
+            within_margin(result.single, result.split) ? result.single
+                                                       : result.split;
+        result.recommended = within_margin(cheaper_no_heap, result.overflow)
+                                 ? cheaper_no_heap
+                                 : result.overflow;
+        return result;
+    }
+
+    template <typename TypeList>
+    autotune_result recommend_slots(const type_histogram<TypeList>& histogram,
+                                    const autotune_options&         options = {})
+    {
+        return recommend_slots(histogram.footprints(), options);
+    }
+
+    inline const char* to_string(slot_strategy strategy) noexcept
+    {
+        switch (strategy)
+        {
+            case slot_strategy::single_slot:
+                return "single_slot";
+            case slot_strategy::size_classes:
+                return "size_classes";
+            case slot_strategy::overflow:
+                return "overflow";
+        }
+        return "unknown";
+    }
+
+} // namespace inline_poly
+
+#endif // INLINE_POLY_AUTOTUNE_H
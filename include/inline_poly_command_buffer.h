@@ -0,0 +1,292 @@
+// Copyright 2025 Dr. Matthias Hölzl
+
+// inline_poly_command_buffer.h - Recorded polymorphic command buffer
+//
+// poly_command_buffer bump-records commands of different sizes into one
+// inline byte buffer, each preceded by a small header holding its
+// type_operations. Recording is a pointer bump; replay() is one linear pass
+// over the buffer calling execute() on every command in recording order.
+// Buffers recorded on different threads (one buffer per thread) can be merged
+// on the consuming thread by concatenation, and reset() destroys the commands
+// while keeping the storage for the next frame.
+
+#pragma once
+#ifndef INLINE_POLY_COMMAND_BUFFER_H
+#define INLINE_POLY_COMMAND_BUFFER_H
+
+#include "inline_poly.h"
+
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+namespace inline_poly
+{
+
+    namespace detail
+    {
+        // Precedes every recorded command; shared by all buffer sizes so
+        // records can be moved between buffers
+        struct command_record_header
+        {
+            const type_operations* ops;
+            std::uint32_t          size;        // Header + payload + padding
+            std::int32_t           base_offset; // Base subobject in payload
+        };
+    } // namespace detail
+
+    template <PolymorphicBase Base, std::size_t Bytes>
+    class poly_command_buffer
+    {
+    public:
+        // Every record starts on this boundary, which makes records position
+        // independent: concatenating buffers never changes their padding
+        static constexpr std::size_t record_alignment = alignof(std::max_align_t);
+
+        static_assert(Bytes % record_alignment == 0,
+                      "Bytes must be a multiple of alignof(std::max_align_t)");
+
+    private:
+        using record_header = detail::command_record_header;
+
+        static constexpr std::size_t header_size =
+            (sizeof(record_header) + record_alignment - 1) / record_alignment *
+            record_alignment;
+
+        alignas(record_alignment) std::byte storage_[Bytes]{};
+        std::size_t used_  = 0;
+        std::size_t count_ = 0;
+
+        template <PolymorphicBase, std::size_t>
+        friend class poly_command_buffer;
+
+    public:
+        poly_command_buffer() = default;
+
+        poly_command_buffer(const poly_command_buffer&)            = delete;
+        poly_command_buffer& operator=(const poly_command_buffer&) = delete;
+
+        poly_command_buffer(poly_command_buffer&& other) noexcept
+        {
+            take_from(other);
+        }
+
+        poly_command_buffer& operator=(poly_command_buffer&& other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                take_from(other);
+            }
+            return *this;
+        }
+
+        ~poly_command_buffer()
+        {
+            reset();
+        }
+
+        // --- Recording ---
+
+        template <typename Derived, typename... Args>
+            requires std::derived_from<Derived, Base> &&
+                     std::constructible_from<Derived, Args...>
+        Derived& emplace_back(Args&&... args)
+        {
+            Derived* command =
+                try_emplace_back<Derived>(std::forward<Args>(args)...);
+            if (!command)
+            {
+                throw std::out_of_range(
+                    "poly_command_buffer::emplace_back() - buffer full");
+            }
+            return *command;
+        }
+
+        // Returns nullptr instead of throwing when the buffer is full
+        template <typename Derived, typename... Args>
+            requires std::derived_from<Derived, Base> &&
+                     std::constructible_from<Derived, Args...>
+        Derived* try_emplace_back(Args&&... args)
+        {
+            static_assert(alignof(Derived) <= record_alignment,
+                          "over-aligned commands are not supported");
+            static_assert(std::is_move_constructible_v<Derived>,
+                          "commands must be move constructible");
+
+            constexpr std::size_t size = record_size(sizeof(Derived));
+            if (size > Bytes - used_)
+            {
+                return nullptr;
+            }
+
+            std::byte* record = storage_ + used_;
+            Derived*   command =
+                new (record + header_size) Derived(std::forward<Args>(args)...);
+
+            const auto& ops = get_type_ops<Derived>();
+            new (record) record_header{
+                .ops         = &ops,
+                .size        = static_cast<std::uint32_t>(size),
+                .base_offset = static_cast<std::int32_t>(
+                    reinterpret_cast<std::byte*>(static_cast<Base*>(command)) -
+                    reinterpret_cast<std::byte*>(command))};
+
+            used_ += size;
+            ++count_;
+            return command;
+        }
+
+        // --- Replay ---
+
+        // Call execute(args...) on every command in recording order
+        template <typename... Args>
+        void replay(Args&&... args)
+        {
+            for_each([&](Base& command) { command.execute(args...); });
+        }
+
+        template <typename Fn>
+        void for_each(Fn&& fn)
+        {
+            for (std::size_t offset = 0; offset < used_;)
+            {
+                const record_header& header = header_at(offset);
+                fn(*base_at(offset, header));
+                offset += header.size;
+            }
+        }
+
+        template <typename Fn>
+        void for_each(Fn&& fn) const
+        {
+            for (std::size_t offset = 0; offset < used_;)
+            {
+                const record_header& header = header_at(offset);
+                fn(*base_at(offset, header));
+                offset += header.size;
+            }
+        }
+
+        // --- Merging ---
+
+        // Move all commands of `other` behind this buffer's commands and
+        // leave `other` empty. Throws std::out_of_range (leaving both buffers
+        // unchanged) if the commands do not fit.
+        template <std::size_t OtherBytes>
+        void append(poly_command_buffer<Base, OtherBytes>&& other)
+        {
+            if (static_cast<const void*>(&other) == this)
+            {
+                throw std::logic_error(
+                    "poly_command_buffer::append() - cannot append to itself");
+            }
+            if (other.used_ > Bytes - used_)
+            {
+                throw std::out_of_range(
+                    "poly_command_buffer::append() - buffer full");
+            }
+
+            for (std::size_t offset = 0; offset < other.used_;)
+            {
+                const record_header& header = other.header_at(offset);
+                relocate_record(storage_ + used_ + offset,
+                                other.storage_ + offset, header);
+                offset += header.size;
+            }
+            used_  += std::exchange(other.used_, 0);
+            count_ += std::exchange(other.count_, 0);
+        }
+
+        // Destroy all commands; the storage is reused without reallocation
+        void reset() noexcept
+        {
+            for (std::size_t offset = 0; offset < used_;)
+            {
+                const record_header& header = header_at(offset);
+                safe_destroy(storage_ + offset + header_size, *header.ops);
+                offset += header.size;
+            }
+            used_  = 0;
+            count_ = 0;
+        }
+
+        // --- Capacity ---
+
+        [[nodiscard]] std::size_t size() const noexcept
+        {
+            return count_;
+        }
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return count_ == 0;
+        }
+        [[nodiscard]] std::size_t bytes_used() const noexcept
+        {
+            return used_;
+        }
+        [[nodiscard]] std::size_t bytes_free() const noexcept
+        {
+            return Bytes - used_;
+        }
+        [[nodiscard]] static constexpr std::size_t capacity_bytes() noexcept
+        {
+            return Bytes;
+        }
+
+        // Bytes one command of the given size occupies, including its header
+        [[nodiscard]] static constexpr std::size_t
+        record_size(std::size_t object_size) noexcept
+        {
+            return header_size + (object_size + record_alignment - 1) /
+                                     record_alignment * record_alignment;
+        }
+
+    private:
+        const record_header& header_at(std::size_t offset) const noexcept
+        {
+            return *std::launder(
+                reinterpret_cast<const record_header*>(storage_ + offset));
+        }
+
+        Base* base_at(std::size_t offset, const record_header& header) noexcept
+        {
+            return std::launder(reinterpret_cast<Base*>(
+                storage_ + offset + header_size + header.base_offset));
+        }
+
+        const Base* base_at(std::size_t offset,
+                            const record_header& header) const noexcept
+        {
+            return std::launder(reinterpret_cast<const Base*>(
+                storage_ + offset + header_size + header.base_offset));
+        }
+
+        // Move-construct the command at src into dst and destroy the source
+        static void relocate_record(std::byte* dst, std::byte* src,
+                                    const record_header& header) noexcept
+        {
+            new (dst) record_header(header);
+            safe_move_construct(dst + header_size, src + header_size,
+                                *header.ops);
+            safe_destroy(src + header_size, *header.ops);
+        }
+
+        void take_from(poly_command_buffer& other) noexcept
+        {
+            for (std::size_t offset = 0; offset < other.used_;)
+            {
+                const record_header& header = other.header_at(offset);
+                relocate_record(storage_ + offset, other.storage_ + offset,
+                                header);
+                offset += header.size;
+            }
+            used_  = std::exchange(other.used_, 0);
+            count_ = std::exchange(other.count_, 0);
+        }
+    };
+
+} // namespace inline_poly
+
+#endif // INLINE_POLY_COMMAND_BUFFER_H
@@ -0,0 +1,879 @@
+// Copyright 2025 Dr. Matthias Hölzl
+
+// inline_poly_ecs.h - Archetype-based entity component system with inline
+// storage
+//
+// Entities are grouped by the exact set of components they carry (their
+// archetype). Each archetype stores one dense, type-segregated inline column
+// per component type it holds, so a query such as query<Position, Velocity>()
+// visits only matching archetypes and walks plain arrays - per-frame update
+// passes become contiguous and vectorizable. Entities are addressed through
+// generational handles, and structural changes made while iterating are
+// recorded in a command_buffer and applied afterwards. Nothing is allocated on
+// the heap; every capacity is a template parameter. Components must be
+// nothrow move constructible.
+
+#pragma once
+#ifndef INLINE_POLY_ECS_H
+#define INLINE_POLY_ECS_H
+
+#include "inline_poly.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace inline_poly::ecs
+{
+
+    // =============================================================================
+    // Entities
+    // =============================================================================
+
+    // Generational handle: the generation is bumped whenever an index is
+    // recycled, so handles to destroyed entities are detected as stale
+    struct entity
+    {
+        static constexpr std::uint32_t invalid_index =
+            std::numeric_limits<std::uint32_t>::max();
+
+        std::uint32_t index      = invalid_index;
+        std::uint32_t generation = 0;
+
+        [[nodiscard]] constexpr bool valid() const noexcept
+        {
+            return index != invalid_index;
+        }
+
+        friend constexpr bool operator==(entity, entity) noexcept = default;
+    };
+
+    using component_mask = std::uint64_t;
+
+    // =============================================================================
+    // Columns - Type-segregated inline storage for one component type
+    // =============================================================================
+
+    // View of one archetype's column of T inside the world's column store
+    template <typename T>
+    class column
+    {
+    public:
+        explicit column(std::byte* storage) noexcept : storage_(storage) {}
+
+        T* data() noexcept
+        {
+            return std::launder(reinterpret_cast<T*>(storage_));
+        }
+
+        template <typename... Args>
+        T& construct(std::size_t row, Args&&... args)
+        {
+            return *new (storage_ + row * sizeof(T))
+                T(std::forward<Args>(args)...);
+        }
+
+        void destroy(std::size_t row) noexcept
+        {
+            data()[row].~T();
+        }
+
+        // Move the element at src into the empty row dst and destroy src
+        void relocate(std::size_t dst, std::size_t src) noexcept
+        {
+            T* elements = data();
+            new (storage_ + dst * sizeof(T)) T(std::move(elements[src]));
+            elements[src].~T();
+        }
+
+    private:
+        std::byte* storage_;
+    };
+
+    namespace detail
+    {
+        // Bytes for one column of Rows elements of every component type,
+        // including the alignment padding in front of each column
+        template <typename ComponentList, std::size_t Rows>
+        struct column_bytes;
+
+        template <typename... Components, std::size_t Rows>
+        struct column_bytes<type_list<Components...>, Rows>
+        {
+            static constexpr std::size_t value =
+                ((Rows * sizeof(Components) + alignof(Components) - 1) + ... +
+                 0);
+        };
+    } // namespace detail
+
+    template <typename World, typename... Ts>
+    class query_view;
+
+    // =============================================================================
+    // World
+    // =============================================================================
+
+    // A new archetype takes one column of ArchetypeCapacity rows for each of
+    // its component types from a column store of ColumnBytes bytes, so only
+    // component sets that actually occur use memory. The default has room
+    // for every component type in four archetypes; creating an archetype
+    // whose columns no longer fit throws std::out_of_range. Allocate large
+    // worlds statically.
+    template <typename ComponentList, std::size_t MaxEntities,
+              std::size_t MaxArchetypes     = 32,
+              std::size_t ArchetypeCapacity = MaxEntities,
+              std::size_t ColumnBytes =
+                  4 * detail::column_bytes<ComponentList,
+                                           ArchetypeCapacity>::value>
+    class world;
+
+    template <typename... Components, std::size_t MaxEntities,
+              std::size_t MaxArchetypes, std::size_t ArchetypeCapacity,
+              std::size_t ColumnBytes>
+    class world<type_list<Components...>, MaxEntities, MaxArchetypes,
+                ArchetypeCapacity, ColumnBytes>
+    {
+    public:
+        static constexpr std::size_t component_count = sizeof...(Components);
+
+        static_assert(component_count >= 1 && component_count <= 64,
+                      "world supports between 1 and 64 component types");
+        // Rows are relocated by move construction during swap-remove and
+        // component replacement, which cannot be undone halfway
+        static_assert((std::is_nothrow_move_constructible_v<Components> && ...),
+                      "components must be nothrow move constructible");
+        static_assert(MaxEntities < entity::invalid_index,
+                      "MaxEntities exceeds the entity index range");
+
+        // Position of T in the component list
+        template <typename T>
+        static constexpr std::size_t component_id = []
+        {
+            constexpr std::array<bool, component_count> matches = {
+                std::is_same_v<std::remove_cv_t<T>, Components>...};
+            std::size_t id = 0;
+            while (id < component_count && !matches[id])
+            {
+                ++id;
+            }
+            return id;
+        }();
+
+        template <typename T>
+        static constexpr bool is_component = component_id<T> < component_count;
+
+        template <typename... Ts>
+        static constexpr component_mask mask_of =
+            ((component_mask{1} << component_id<Ts>) | ... | component_mask{0});
+
+    private:
+        struct archetype
+        {
+            component_mask mask  = 0;
+            std::size_t    count = 0;
+            std::array<std::uint32_t, ArchetypeCapacity> entities{};
+            // Offsets into the column store, valid for the components in mask
+            std::array<std::size_t, component_count> columns{};
+        };
+
+        struct entity_record
+        {
+            std::uint32_t generation = 0;
+            std::uint32_t archetype  = entity::invalid_index;
+            std::uint32_t row        = 0;
+        };
+
+        static constexpr std::uint32_t no_archetype = entity::invalid_index;
+
+        std::array<archetype, MaxArchetypes>   archetypes_{};
+        std::size_t                            archetype_count_ = 1; // [0]: {}
+        std::array<entity_record, MaxEntities> records_{};
+        std::array<std::uint32_t, MaxEntities> free_indices_{};
+        std::size_t                            free_count_  = 0;
+        std::uint32_t                          next_index_  = 0;
+        std::size_t                            alive_count_ = 0;
+
+        static constexpr std::size_t store_alignment =
+            std::max({alignof(Components)...});
+
+        alignas(store_alignment) std::byte column_store_[ColumnBytes];
+        std::size_t column_store_used_ = 0;
+
+        template <typename, typename...>
+        friend class query_view;
+
+    public:
+        world() = default;
+
+        world(const world&)            = delete;
+        world& operator=(const world&) = delete;
+
+        ~world()
+        {
+            clear();
+        }
+
+        // --- Entities ---
+
+        entity create()
+        {
+            check_capacity(archetypes_[0], "create");
+            return allocate_entity(0, archetypes_[0].count++);
+        }
+
+        // Create an entity directly in the archetype of its components
+        template <typename... Ts>
+            requires(is_component<std::remove_cvref_t<Ts>> && ...)
+        entity create(Ts&&... components)
+        {
+            constexpr component_mask mask = mask_of<std::remove_cvref_t<Ts>...>;
+            static_assert(std::popcount(mask) == sizeof...(Ts),
+                          "create() takes each component type at most once");
+
+            const std::uint32_t arch_index = find_or_create_archetype(mask);
+            archetype&          arch       = archetypes_[arch_index];
+            check_capacity(arch, "create");
+
+            const std::size_t row         = arch.count;
+            std::size_t       constructed = 0;
+            try
+            {
+                ((column_of<std::remove_cvref_t<Ts>>(arch).construct(
+                      row, std::forward<Ts>(components)),
+                  ++constructed),
+                 ...);
+            }
+            catch (...)
+            {
+                std::size_t i = 0;
+                ((i++ < constructed
+                      ? column_of<std::remove_cvref_t<Ts>>(arch).destroy(row)
+                      : void()),
+                 ...);
+                throw;
+            }
+            ++arch.count;
+            return allocate_entity(arch_index, row);
+        }
+
+        void destroy(entity e)
+        {
+            entity_record& record = checked_record(e, "destroy");
+            remove_row(record.archetype, record.row);
+            record.archetype = no_archetype;
+            ++record.generation;
+            free_indices_[free_count_++] = e.index;
+            --alive_count_;
+        }
+
+        [[nodiscard]] bool alive(entity e) const noexcept
+        {
+            return e.index < next_index_ &&
+                   records_[e.index].generation == e.generation &&
+                   records_[e.index].archetype != no_archetype;
+        }
+
+        // Destroy all entities; outstanding handles become stale
+        void clear() noexcept
+        {
+            for (std::size_t a = 0; a < archetype_count_; ++a)
+            {
+                archetype& arch = archetypes_[a];
+                for (std::size_t row = 0; row < arch.count; ++row)
+                {
+                    destroy_components(arch, row);
+                    entity_record& record = records_[arch.entities[row]];
+                    record.archetype      = no_archetype;
+                    ++record.generation;
+                    free_indices_[free_count_++] = arch.entities[row];
+                }
+                arch.count = 0;
+            }
+            alive_count_ = 0;
+        }
+
+        // --- Components ---
+
+        // Add (or replace) a component. Moves the entity to the archetype
+        // that includes T.
+        template <typename T, typename... Args>
+            requires is_component<T> && std::constructible_from<T, Args...>
+        T& add(entity e, Args&&... args)
+        {
+            entity_record& record = checked_record(e, "add");
+            archetype&     source = archetypes_[record.archetype];
+            if (source.mask & mask_of<T>)
+            {
+                // Build the replacement first so a throwing constructor
+                // leaves the old component in place; the move into the row
+                // cannot throw
+                T         replacement(std::forward<Args>(args)...);
+                column<T> col = column_of<T>(source);
+                col.destroy(record.row);
+                return col.construct(record.row, std::move(replacement));
+            }
+
+            const std::uint32_t target_index =
+                find_or_create_archetype(source.mask | mask_of<T>);
+            archetype& target = archetypes_[target_index];
+            if (target.count >= ArchetypeCapacity)
+            {
+                throw std::out_of_range(
+                    "ecs::world::add() - archetype capacity exceeded");
+            }
+
+            // Construct the new component first so a throwing constructor
+            // leaves the entity untouched
+            const std::size_t new_row = target.count;
+            T& added = column_of<T>(target).construct(
+                new_row, std::forward<Args>(args)...);
+            move_row(source, record.row, target, new_row);
+            target.entities[new_row] = e.index;
+            ++target.count;
+
+            remove_row(record.archetype, record.row);
+            record.archetype = target_index;
+            record.row       = static_cast<std::uint32_t>(new_row);
+            return added;
+        }
+
+        template <typename T>
+            requires is_component<T>
+        void remove(entity e)
+        {
+            entity_record& record = checked_record(e, "remove");
+            archetype&     source = archetypes_[record.archetype];
+            if (!(source.mask & mask_of<T>))
+            {
+                return;
+            }
+
+            const std::uint32_t target_index =
+                find_or_create_archetype(source.mask & ~mask_of<T>);
+            archetype& target = archetypes_[target_index];
+            if (target.count >= ArchetypeCapacity)
+            {
+                throw std::out_of_range(
+                    "ecs::world::remove() - archetype capacity exceeded");
+            }
+
+            const std::size_t new_row = target.count;
+            move_row(source, record.row, target, new_row);
+            target.entities[new_row] = e.index;
+            ++target.count;
+
+            remove_row(record.archetype, record.row);
+            record.archetype = target_index;
+            record.row       = static_cast<std::uint32_t>(new_row);
+        }
+
+        template <typename T>
+            requires is_component<T>
+        [[nodiscard]] T* get(entity e) noexcept
+        {
+            if (!alive(e))
+            {
+                return nullptr;
+            }
+            const entity_record& record = records_[e.index];
+            archetype&           arch   = archetypes_[record.archetype];
+            if (!(arch.mask & mask_of<T>))
+            {
+                return nullptr;
+            }
+            return column_of<T>(arch).data() + record.row;
+        }
+
+        template <typename T>
+            requires is_component<T>
+        [[nodiscard]] bool has(entity e) const noexcept
+        {
+            return alive(e) &&
+                   (archetypes_[records_[e.index].archetype].mask & mask_of<T>);
+        }
+
+        // --- Queries ---
+
+        // Iterate all entities that have (at least) the components Ts. Use
+        // `const T` for read-only access.
+        template <typename... Ts>
+            requires(sizeof...(Ts) >= 1 &&
+                     (is_component<std::remove_const_t<Ts>> && ...))
+        query_view<world, Ts...> query() noexcept
+        {
+            return query_view<world, Ts...>(*this);
+        }
+
+        // --- Statistics ---
+
+        [[nodiscard]] std::size_t size() const noexcept
+        {
+            return alive_count_;
+        }
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return alive_count_ == 0;
+        }
+        [[nodiscard]] static constexpr std::size_t capacity() noexcept
+        {
+            return MaxEntities;
+        }
+        [[nodiscard]] std::size_t archetype_count() const noexcept
+        {
+            return archetype_count_;
+        }
+
+    private:
+        void check_capacity(const archetype& arch, const char* operation) const
+        {
+            if (free_count_ == 0 && next_index_ >= MaxEntities)
+            {
+                throw std::out_of_range(std::string("ecs::world::") + operation +
+                                        "() - capacity exceeded");
+            }
+            if (arch.count >= ArchetypeCapacity)
+            {
+                throw std::out_of_range(std::string("ecs::world::") + operation +
+                                        "() - archetype capacity exceeded");
+            }
+        }
+
+        // Assign an entity index to a row that has already been filled
+        entity allocate_entity(std::uint32_t arch_index, std::size_t row) noexcept
+        {
+            const std::uint32_t index =
+                free_count_ ? free_indices_[--free_count_] : next_index_++;
+            entity_record& record = records_[index];
+            record.archetype      = arch_index;
+            record.row            = static_cast<std::uint32_t>(row);
+            archetypes_[arch_index].entities[row] = index;
+            ++alive_count_;
+            return {.index = index, .generation = record.generation};
+        }
+
+        template <typename T>
+        column<std::remove_cv_t<T>> column_of(archetype& arch) noexcept
+        {
+            return column<std::remove_cv_t<T>>(
+                column_store_ + arch.columns[component_id<T>]);
+        }
+
+        // Call fn(source_column, target_column) for each component in mask
+        template <typename Fn>
+        void for_each_column(component_mask mask, archetype& source,
+                             archetype& target, Fn&& fn)
+        {
+            ((mask & mask_of<Components>
+                  ? fn(column_of<Components>(source),
+                       column_of<Components>(target))
+                  : void()),
+             ...);
+        }
+
+        entity_record& checked_record(entity e, const char* operation)
+        {
+            if (!alive(e))
+            {
+                throw std::invalid_argument(std::string("ecs::world::") +
+                                            operation + "() - stale entity");
+            }
+            return records_[e.index];
+        }
+
+        std::uint32_t find_or_create_archetype(component_mask mask)
+        {
+            for (std::size_t a = 0; a < archetype_count_; ++a)
+            {
+                if (archetypes_[a].mask == mask)
+                {
+                    return static_cast<std::uint32_t>(a);
+                }
+            }
+            if (archetype_count_ >= MaxArchetypes)
+            {
+                throw std::out_of_range(
+                    "ecs::world - archetype limit exceeded");
+            }
+
+            // Carve one column per component of the archetype out of the
+            // column store; archetypes are never removed, so the store only
+            // grows
+            std::array<std::size_t, component_count> columns{};
+            std::size_t                              end = column_store_used_;
+            (
+                [&]
+                {
+                    constexpr std::size_t id = component_id<Components>;
+                    if (mask & mask_of<Components>)
+                    {
+                        columns[id] = (end + alignof(Components) - 1) /
+                                      alignof(Components) * alignof(Components);
+                        end = columns[id] +
+                              ArchetypeCapacity * sizeof(Components);
+                    }
+                }(),
+                ...);
+            if (end > ColumnBytes)
+            {
+                throw std::out_of_range(
+                    "ecs::world - column storage exhausted");
+            }
+            column_store_used_ = end;
+
+            archetype& arch = archetypes_[archetype_count_];
+            arch.mask       = mask;
+            arch.count      = 0;
+            arch.columns    = columns;
+            return static_cast<std::uint32_t>(archetype_count_++);
+        }
+
+        // Move the components shared by both archetypes from source[src_row]
+        // into target[dst_row]; the source row keeps moved-from objects
+        void move_row(archetype& source, std::size_t src_row, archetype& target,
+                      std::size_t dst_row)
+        {
+            for_each_column(source.mask & target.mask, source, target,
+                            [&](auto from, auto to)
+                            {
+                                to.construct(dst_row,
+                                             std::move(from.data()[src_row]));
+                            });
+        }
+
+        void destroy_components(archetype& arch, std::size_t row) noexcept
+        {
+            for_each_column(arch.mask, arch, arch,
+                            [&](auto col, auto) { col.destroy(row); });
+        }
+
+        void remove_row(std::uint32_t arch_index, std::size_t row) noexcept
+        {
+            archetype& arch = archetypes_[arch_index];
+            destroy_components(arch, row);
+            fill_hole(arch, row);
+        }
+
+        // Swap-remove: relocate the last row into the (destroyed) row
+        void fill_hole(archetype& arch, std::size_t row) noexcept
+        {
+            const std::size_t last = arch.count - 1;
+            if (row != last)
+            {
+                for_each_column(arch.mask, arch, arch, [&](auto col, auto)
+                                { col.relocate(row, last); });
+                arch.entities[row] = arch.entities[last];
+                records_[arch.entities[row]].row =
+                    static_cast<std::uint32_t>(row);
+            }
+            --arch.count;
+        }
+    };
+
+    // =============================================================================
+    // Queries
+    // =============================================================================
+
+    template <typename World, typename... Ts>
+    class query_view
+    {
+    public:
+        explicit query_view(World& w) noexcept : world_(w) {}
+
+        // fn(Ts&...) for every matching entity
+        template <typename Fn>
+        void each(Fn&& fn)
+        {
+            each_chunk(
+                [&](std::size_t count, Ts*... columns)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        fn(columns[i]...);
+                    }
+                });
+        }
+
+        // fn(entity, Ts&...) for every matching entity
+        template <typename Fn>
+        void each_with_entity(Fn&& fn)
+        {
+            for_each_archetype(
+                [&](auto& arch)
+                {
+                    for (std::size_t i = 0; i < arch.count; ++i)
+                    {
+                        const std::uint32_t index = arch.entities[i];
+                        const entity e{
+                            .index      = index,
+                            .generation = world_.records_[index].generation};
+                        fn(e, column_data<Ts>(arch)[i]...);
+                    }
+                });
+        }
+
+        // fn(count, Ts*...) once per matching archetype with dense column
+        // pointers - the form to write vectorizable loops against
+        template <typename Fn>
+        void each_chunk(Fn&& fn)
+        {
+            for_each_archetype([&](auto& arch)
+                               { fn(arch.count, column_data<Ts>(arch)...); });
+        }
+
+        [[nodiscard]] std::size_t count()
+        {
+            std::size_t total = 0;
+            for_each_archetype([&](auto& arch) { total += arch.count; });
+            return total;
+        }
+
+    private:
+        static constexpr component_mask required =
+            World::template mask_of<std::remove_const_t<Ts>...>;
+
+        template <typename T, typename Archetype>
+        T* column_data(Archetype& arch) noexcept
+        {
+            return world_.template column_of<T>(arch).data();
+        }
+
+        template <typename Fn>
+        void for_each_archetype(Fn&& fn)
+        {
+            for (std::size_t a = 0; a < world_.archetype_count_; ++a)
+            {
+                auto& arch = world_.archetypes_[a];
+                if ((arch.mask & required) == required && arch.count != 0)
+                {
+                    fn(arch);
+                }
+            }
+        }
+
+        World& world_;
+    };
+
+
+    // =============================================================================
+    // Command Buffer - Deferred structural changes
+    // =============================================================================
+
+    // Records destroy/add/remove commands into an inline byte buffer while a
+    // query is running and applies them in recording order on flush().
+    // Component payloads are constructed in the buffer and relocated into
+    // the world via their type_operations. Commands that target an entity
+    // that is no longer alive at flush time are skipped.
+    template <typename World, std::size_t Bytes = 4096>
+    class command_buffer
+    {
+    private:
+        using apply_fn = void (*)(World& w, entity e, void* payload);
+
+        struct command
+        {
+            entity                 target;
+            apply_fn               apply;
+            const type_operations* ops; // payload type, nullptr if none
+            std::uint32_t          payload_offset;
+        };
+
+        alignas(std::max_align_t) std::byte buffer_[Bytes]{};
+        std::size_t                          used_  = 0;
+        std::size_t                          count_ = 0;
+        World&                               world_;
+
+    public:
+        explicit command_buffer(World& w) noexcept : world_(w) {}
+
+        command_buffer(const command_buffer&)            = delete;
+        command_buffer& operator=(const command_buffer&) = delete;
+
+        ~command_buffer()
+        {
+            discard();
+        }
+
+        // Creating an entity only touches the component-less archetype,
+        // which no query visits, so it is applied immediately and the
+        // handle can be used in subsequent commands
+        entity create()
+        {
+            return world_.create();
+        }
+
+        void destroy(entity e)
+        {
+            record(e, [](World& w, entity target, void*) { w.destroy(target); },
+                   nullptr, 0, 1);
+        }
+
+        template <typename T, typename... Args>
+            requires World::template is_component<T> &&
+                     std::constructible_from<T, Args...>
+        void add(entity e, Args&&... args)
+        {
+            void* payload = record(
+                e,
+                [](World& w, entity target, void* p)
+                { w.template add<T>(target, std::move(*static_cast<T*>(p))); },
+                &get_type_ops<T>(), sizeof(T), alignof(T));
+            try
+            {
+                new (payload) T(std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                rollback_last();
+                throw;
+            }
+        }
+
+        template <typename T>
+            requires World::template is_component<T>
+        void remove(entity e)
+        {
+            record(e, [](World& w, entity target, void*)
+                   { w.template remove<T>(target); },
+                   nullptr, 0, 1);
+        }
+
+        // Apply all recorded commands in order and reset the buffer
+        void flush()
+        {
+            std::size_t offset = 0;
+            std::size_t index  = 0;
+            try
+            {
+                for (; index < count_; ++index)
+                {
+                    command* cmd = command_at(offset);
+                    void*    payload = buffer_ + cmd->payload_offset;
+                    if (world_.alive(cmd->target))
+                    {
+                        cmd->apply(world_, cmd->target, payload);
+                    }
+                    release_payload(*cmd);
+                    offset = next_offset(*cmd);
+                }
+            }
+            catch (...)
+            {
+                // The failing command's payload and all later ones
+                release_from(offset, index);
+                used_  = 0;
+                count_ = 0;
+                throw;
+            }
+            used_  = 0;
+            count_ = 0;
+        }
+
+        // Drop all recorded commands without applying them
+        void discard() noexcept
+        {
+            release_from(0, 0);
+            used_  = 0;
+            count_ = 0;
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept
+        {
+            return count_;
+        }
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return count_ == 0;
+        }
+        [[nodiscard]] std::size_t bytes_used() const noexcept
+        {
+            return used_;
+        }
+        [[nodiscard]] static constexpr std::size_t capacity_bytes() noexcept
+        {
+            return Bytes;
+        }
+
+    private:
+        static constexpr std::size_t align_up(std::size_t offset,
+                                              std::size_t alignment) noexcept
+        {
+            return (offset + alignment - 1) & ~(alignment - 1);
+        }
+
+        // Layout per command: [command header][padding][payload]
+        void* record(entity e, apply_fn apply, const type_operations* ops,
+                     std::size_t payload_size, std::size_t payload_align)
+        {
+            const std::size_t header = align_up(used_, alignof(command));
+            const std::size_t payload =
+                align_up(header + sizeof(command), payload_align);
+            const std::size_t end = payload + payload_size;
+            if (end > Bytes || payload_align > alignof(std::max_align_t))
+            {
+                throw std::out_of_range(
+                    "ecs::command_buffer::record() - buffer full");
+            }
+
+            new (buffer_ + header)
+                command{.target         = e,
+                        .apply          = apply,
+                        .ops            = ops,
+                        .payload_offset = static_cast<std::uint32_t>(payload)};
+            used_ = end;
+            ++count_;
+            return buffer_ + payload;
+        }
+
+        // Forget the most recent command (its payload was never constructed)
+        void rollback_last() noexcept
+        {
+            std::size_t offset = 0;
+            for (std::size_t i = 0; i + 1 < count_; ++i)
+            {
+                offset = next_offset(*command_at(offset));
+            }
+            used_ = offset;
+            --count_;
+        }
+
+        command* command_at(std::size_t offset) noexcept
+        {
+            return std::launder(reinterpret_cast<command*>(
+                buffer_ + align_up(offset, alignof(command))));
+        }
+
+        std::size_t next_offset(const command& cmd) const noexcept
+        {
+            return cmd.payload_offset + (cmd.ops ? cmd.ops->size : 0);
+        }
+
+        void release_payload(const command& cmd) noexcept
+        {
+            if (cmd.ops)
+            {
+                safe_destroy(buffer_ + cmd.payload_offset, *cmd.ops);
+            }
+        }
+
+        void release_from(std::size_t offset, std::size_t index) noexcept
+        {
+            for (; index < count_; ++index)
+            {
+                command* cmd = command_at(offset);
+                release_payload(*cmd);
+                offset = next_offset(*cmd);
+            }
+        }
+    };
+
+} // namespace inline_poly::ecs
+
+#endif // INLINE_POLY_ECS_H
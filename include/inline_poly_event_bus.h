@@ -0,0 +1,436 @@
+// Copyright 2025 Dr. Matthias Hölzl
+
+// inline_poly_event_bus.h - Type-routed event bus with inline event storage
+//
+// poly_event_bus queues events of the types listed in its type_list in an
+// inline byte buffer. Every event type has a dense index fixed at compile
+// time, which selects its subscriber list from a precomputed table - no
+// dynamic_cast or map lookup per event. Queued events of the same type are
+// chained together, so dispatch() runs each handler over all events of its
+// type in one tight loop. Events are destroyed through their type_operations.
+
+#pragma once
+#ifndef INLINE_POLY_EVENT_BUS_H
+#define INLINE_POLY_EVENT_BUS_H
+
+#include "inline_poly.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+namespace inline_poly
+{
+
+    // Identifies one subscription for unsubscribe()
+    struct subscription
+    {
+        std::uint16_t type = std::numeric_limits<std::uint16_t>::max();
+        std::uint16_t slot = 0;
+    };
+
+    template <PolymorphicBase EventBase, typename EventList,
+              std::size_t Bytes = 4096, std::size_t MaxHandlers = 8>
+    class poly_event_bus;
+
+    template <PolymorphicBase EventBase, typename... Events, std::size_t Bytes,
+              std::size_t MaxHandlers>
+    class poly_event_bus<EventBase, type_list<Events...>, Bytes, MaxHandlers>
+    {
+    public:
+        static constexpr std::size_t event_type_count = sizeof...(Events);
+        static constexpr std::size_t record_alignment = alignof(std::max_align_t);
+
+        static_assert(event_type_count >= 1 &&
+                          event_type_count <
+                              std::numeric_limits<std::uint16_t>::max(),
+                      "poly_event_bus needs at least one event type");
+        static_assert((std::derived_from<Events, EventBase> && ...),
+                      "all events must derive from EventBase");
+        static_assert(((alignof(Events) <= record_alignment) && ...),
+                      "over-aligned events are not supported");
+        static_assert(Bytes % record_alignment == 0,
+                      "Bytes must be a multiple of alignof(std::max_align_t)");
+        static_assert(Bytes < std::numeric_limits<std::uint32_t>::max(),
+                      "Bytes exceeds the record offset range");
+
+        // Dense index of E in the event list
+        template <typename E>
+        static constexpr std::size_t type_index = []
+        {
+            constexpr std::array<bool, event_type_count> matches = {
+                std::is_same_v<E, Events>...};
+            std::size_t index = 0;
+            while (index < event_type_count && !matches[index])
+            {
+                ++index;
+            }
+            return index;
+        }();
+
+        template <typename E>
+        static constexpr bool is_event = type_index<E> < event_type_count;
+
+    private:
+        static constexpr std::uint32_t npos =
+            std::numeric_limits<std::uint32_t>::max();
+
+        struct record_header
+        {
+            const type_operations* ops;
+            std::uint32_t          size;      // Header + payload + padding
+            std::uint32_t          next_same; // Next event of the same type
+            std::uint16_t          type;
+        };
+
+        static constexpr std::size_t header_size =
+            (sizeof(record_header) + record_alignment - 1) / record_alignment *
+            record_alignment;
+
+        struct handler
+        {
+            void (*invoke)(void* target, const void* event) = nullptr;
+            void* target                                    = nullptr;
+        };
+
+        // Unsubscribed entries are cleared in place so that the slots of
+        // other subscriptions stay valid
+        struct handler_list
+        {
+            std::array<handler, MaxHandlers> handlers{};
+            std::size_t                      count  = 0; // High-water slot
+            std::size_t                      active = 0;
+        };
+
+        struct event_chain
+        {
+            std::uint32_t first = npos;
+            std::uint32_t last  = npos;
+            std::size_t   count = 0;
+        };
+
+        alignas(record_alignment) std::byte storage_[Bytes]{};
+        std::size_t                                used_  = 0;
+        std::size_t                                count_ = 0;
+        std::array<event_chain, event_type_count>  chains_{};
+        std::array<handler_list, event_type_count> subscribers_{};
+        bool                                       dispatching_ = false;
+
+    public:
+        poly_event_bus() = default;
+
+        poly_event_bus(const poly_event_bus&)            = delete;
+        poly_event_bus& operator=(const poly_event_bus&) = delete;
+
+        ~poly_event_bus()
+        {
+            clear();
+        }
+
+        // --- Subscriptions ---
+
+        // Call handler(event) for each dispatched event of type E. The
+        // handler object is referenced, not copied, and must outlive the
+        // subscription.
+        template <typename E, typename Handler>
+            requires is_event<E> && (!std::is_function_v<Handler>) &&
+                     std::invocable<Handler&, const E&>
+        subscription subscribe(Handler& handler_object)
+        {
+            return add_handler(
+                type_index<E>,
+                {.invoke =
+                     [](void* target, const void* event)
+                 {
+                     (*static_cast<Handler*>(target))(
+                         *static_cast<const E*>(event));
+                 },
+                 .target = &handler_object});
+        }
+
+        // Subscribe a plain function
+        template <typename E>
+            requires is_event<E>
+        subscription subscribe(void (*function)(const E&))
+        {
+            // The function pointer travels as the target; converting it to
+            // void* is conditionally supported but available on all
+            // supported compilers
+            static_assert(sizeof(function) <= sizeof(void*));
+            handler entry{.invoke =
+                              [](void* target, const void* event)
+                          {
+                              auto fn = reinterpret_cast<void (*)(const E&)>(
+                                  target);
+                              fn(*static_cast<const E*>(event));
+                          },
+                          .target = reinterpret_cast<void*>(function)};
+            return add_handler(type_index<E>, entry);
+        }
+
+        void unsubscribe(subscription id)
+        {
+            if (dispatching_)
+            {
+                throw std::logic_error(
+                    "poly_event_bus::unsubscribe() - called during dispatch");
+            }
+            if (id.type >= event_type_count ||
+                id.slot >= subscribers_[id.type].count ||
+                !subscribers_[id.type].handlers[id.slot].invoke)
+            {
+                throw std::out_of_range(
+                    "poly_event_bus::unsubscribe() - invalid subscription");
+            }
+            handler_list& list     = subscribers_[id.type];
+            list.handlers[id.slot] = {};
+            --list.active;
+            while (list.count > 0 && !list.handlers[list.count - 1].invoke)
+            {
+                --list.count;
+            }
+        }
+
+        template <typename E>
+            requires is_event<E>
+        [[nodiscard]] std::size_t subscriber_count() const noexcept
+        {
+            return subscribers_[type_index<E>].active;
+        }
+
+        // --- Publishing ---
+
+        template <typename E, typename... Args>
+            requires is_event<E> && std::constructible_from<E, Args...>
+        E& publish(Args&&... args)
+        {
+            constexpr std::size_t size = record_size(sizeof(E));
+            if (size > Bytes - used_)
+            {
+                throw std::out_of_range("poly_event_bus::publish() - queue full");
+            }
+
+            std::byte* record = storage_ + used_;
+            E* event = new (record + header_size) E(std::forward<Args>(args)...);
+            new (record) record_header{
+                .ops       = &get_type_ops<E>(),
+                .size      = static_cast<std::uint32_t>(size),
+                .next_same = npos,
+                .type      = static_cast<std::uint16_t>(type_index<E>)};
+            link(static_cast<std::uint32_t>(used_), type_index<E>);
+            used_ += size;
+            ++count_;
+            return *event;
+        }
+
+        // --- Dispatch ---
+
+        // Deliver every event queued before the call, grouped by type in
+        // type-list order: each handler of a type sees all of that type's
+        // events (in publishing order) before the next handler runs. Events
+        // published by handlers stay queued for the next dispatch().
+        void dispatch()
+        {
+            if (dispatching_)
+            {
+                throw std::logic_error(
+                    "poly_event_bus::dispatch() - called recursively");
+            }
+            dispatching_ = true;
+
+            const std::size_t end      = used_;
+            const auto        snapshot = chains_;
+            try
+            {
+                for (std::size_t type = 0; type < event_type_count; ++type)
+                {
+                    deliver(type, snapshot[type]);
+                }
+            }
+            catch (...)
+            {
+                retire(end);
+                dispatching_ = false;
+                throw;
+            }
+            retire(end);
+            dispatching_ = false;
+        }
+
+        // Destroy all queued events without delivering them
+        void clear() noexcept
+        {
+            for (std::size_t offset = 0; offset < used_;)
+            {
+                const record_header& header = header_at(offset);
+                safe_destroy(storage_ + offset + header_size, *header.ops);
+                offset += header.size;
+            }
+            used_  = 0;
+            count_ = 0;
+            chains_.fill({});
+        }
+
+        // --- Queries ---
+
+        [[nodiscard]] std::size_t size() const noexcept
+        {
+            return count_;
+        }
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return count_ == 0;
+        }
+        template <typename E>
+            requires is_event<E>
+        [[nodiscard]] std::size_t queued() const noexcept
+        {
+            return chains_[type_index<E>].count;
+        }
+        [[nodiscard]] std::size_t bytes_used() const noexcept
+        {
+            return used_;
+        }
+        [[nodiscard]] static constexpr std::size_t capacity_bytes() noexcept
+        {
+            return Bytes;
+        }
+
+        [[nodiscard]] static constexpr std::size_t
+        record_size(std::size_t object_size) noexcept
+        {
+            return header_size + (object_size + record_alignment - 1) /
+                                     record_alignment * record_alignment;
+        }
+
+    private:
+        static constexpr std::size_t max_event_size =
+            max_size_v<type_list<Events...>>;
+
+        static void relocate(void* dst, void* src,
+                             const type_operations& ops) noexcept
+        {
+            safe_move_construct(dst, src, ops);
+            safe_destroy(src, ops);
+        }
+
+        record_header& header_at(std::size_t offset) noexcept
+        {
+            return *std::launder(
+                reinterpret_cast<record_header*>(storage_ + offset));
+        }
+
+        subscription add_handler(std::size_t type, handler entry)
+        {
+            if (dispatching_)
+            {
+                throw std::logic_error(
+                    "poly_event_bus::subscribe() - called during dispatch");
+            }
+            handler_list& list = subscribers_[type];
+            if (list.active >= MaxHandlers)
+            {
+                throw std::out_of_range(
+                    "poly_event_bus::subscribe() - too many handlers");
+            }
+            std::size_t slot = 0;
+            while (slot < list.count && list.handlers[slot].invoke)
+            {
+                ++slot;
+            }
+            list.handlers[slot] = entry;
+            list.count          = std::max(list.count, slot + 1);
+            ++list.active;
+            return {.type = static_cast<std::uint16_t>(type),
+                    .slot = static_cast<std::uint16_t>(slot)};
+        }
+
+        void link(std::uint32_t offset, std::size_t type) noexcept
+        {
+            event_chain& chain = chains_[type];
+            if (chain.last == npos)
+            {
+                chain.first = offset;
+            }
+            else
+            {
+                header_at(chain.last).next_same = offset;
+            }
+            chain.last = offset;
+            ++chain.count;
+        }
+
+        void deliver(std::size_t type, const event_chain& chain)
+        {
+            const handler_list& list = subscribers_[type];
+            for (std::size_t h = 0; h < list.count; ++h)
+            {
+                const handler entry = list.handlers[h];
+                if (!entry.invoke)
+                {
+                    continue;
+                }
+                std::uint32_t offset = chain.first;
+                for (std::size_t n = 0; n < chain.count; ++n)
+                {
+                    entry.invoke(entry.target, storage_ + offset + header_size);
+                    offset = header_at(offset).next_same;
+                }
+            }
+        }
+
+        // Destroy the delivered events in [0, end) and move events published
+        // during dispatch to the front of the buffer. A record that would
+        // overlap its own destination is staged in a stack buffer.
+        void retire(std::size_t end) noexcept
+        {
+            for (std::size_t offset = 0; offset < end;)
+            {
+                const record_header& header = header_at(offset);
+                safe_destroy(storage_ + offset + header_size, *header.ops);
+                offset += header.size;
+            }
+
+            const std::size_t pending_end = used_;
+            used_                         = 0;
+            count_                        = 0;
+            chains_.fill({});
+            for (std::size_t offset = end; offset < pending_end;)
+            {
+                const record_header header = header_at(offset);
+                std::byte*          dst    = storage_ + used_;
+                std::byte*          src    = storage_ + offset;
+                new (dst) record_header{.ops       = header.ops,
+                                        .size      = header.size,
+                                        .next_same = npos,
+                                        .type      = header.type};
+                if (dst + header.size > src)
+                {
+                    alignas(record_alignment) std::byte staging[max_event_size];
+                    relocate(staging, src + header_size, *header.ops);
+                    relocate(dst + header_size, staging, *header.ops);
+                }
+                else
+                {
+                    relocate(dst + header_size, src + header_size, *header.ops);
+                }
+                link(static_cast<std::uint32_t>(used_), header.type);
+                used_ += header.size;
+                ++count_;
+                offset += header.size;
+            }
+        }
+    };
+
+    // Convenience alias
+    template <PolymorphicBase EventBase, typename EventList,
+              std::size_t Bytes = 4096, std::size_t MaxHandlers = 8>
+    using event_bus = poly_event_bus<EventBase, EventList, Bytes, MaxHandlers>;
+
+} // namespace inline_poly
+
+#endif // INLINE_POLY_EVENT_BUS_H
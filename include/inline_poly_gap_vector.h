@@ -0,0 +1,520 @@
+// Copyright 2025 Dr. Matthias Hölzl
+
+// inline_poly_gap_vector.h - Polymorphic gap buffer for cursor-local editing
+//
+// poly_gap_vector keeps its free slots as a single gap at a movable cursor,
+// like the gap buffer of a text editor. Inserting or erasing at the cursor is
+// O(1); moving the cursor relocates only the elements between its old and
+// new position. Indexing and iteration use logical positions and skip the
+// gap.
+//
+// When every element's type is trivially relocatable (see
+// is_trivially_relocatable in inline_poly.h), a cursor move relocates the
+// whole run of elements with one memmove instead of one call per element.
+
+#pragma once
+#ifndef INLINE_POLY_GAP_VECTOR_H
+#define INLINE_POLY_GAP_VECTOR_H
+
+#include "inline_poly.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+namespace inline_poly
+{
+
+    template <PolymorphicBase Base, size_t N, size_t SlotSize = sizeof(Base),
+              size_t Alignment = alignof(Base)>
+    class poly_gap_vector
+    {
+    public:
+        static_assert(SlotSize >= sizeof(Base), "SlotSize must hold Base");
+        static_assert(Alignment >= alignof(Base),
+                      "Alignment must be at least alignof(Base)");
+        static_assert(SlotSize % Alignment == 0,
+                      "SlotSize must be a multiple of Alignment");
+
+        using value_type      = Base*;
+        using size_type       = size_t;
+        using difference_type = std::ptrdiff_t;
+
+    private:
+        // Per physical slot; Base is found at base_offset into the slot, so
+        // relocating an element only moves bytes
+        struct slot_meta
+        {
+            const type_operations* ops         = nullptr;
+            std::uint32_t          base_offset = 0;
+        };
+
+        alignas(Alignment) std::byte storage_[N * SlotSize]{};
+        std::array<slot_meta, N> meta_{};
+        size_type                gap_begin_     = 0; // Logical cursor
+        size_type                gap_end_       = N;
+        size_type                non_copyable_  = 0;
+        size_type                non_trivial_   = 0; // Not trivially relocatable
+
+    public:
+        // Bidirectional iterator over logical positions, skipping the gap
+        template <typename Vector, typename Pointer>
+        class basic_iterator
+        {
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type        = Pointer;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = void;
+            using reference         = Pointer;
+
+            basic_iterator() = default;
+            basic_iterator(Vector* vec, size_type index) :
+                vec_(vec), index_(index)
+            {}
+
+            reference operator*() const
+            {
+                return (*vec_)[index_];
+            }
+            basic_iterator& operator++()
+            {
+                ++index_;
+                return *this;
+            }
+            basic_iterator operator++(int)
+            {
+                basic_iterator tmp = *this;
+                ++index_;
+                return tmp;
+            }
+            basic_iterator& operator--()
+            {
+                --index_;
+                return *this;
+            }
+            basic_iterator operator--(int)
+            {
+                basic_iterator tmp = *this;
+                --index_;
+                return tmp;
+            }
+            [[nodiscard]] size_type index() const noexcept
+            {
+                return index_;
+            }
+            bool operator==(const basic_iterator& other) const
+            {
+                return index_ == other.index_;
+            }
+
+        private:
+            Vector*   vec_   = nullptr;
+            size_type index_ = 0;
+        };
+
+        using iterator       = basic_iterator<poly_gap_vector, Base*>;
+        using const_iterator = basic_iterator<const poly_gap_vector, const Base*>;
+
+        poly_gap_vector() noexcept = default;
+
+        poly_gap_vector(const poly_gap_vector& other)
+        {
+            copy_from(other);
+        }
+
+        poly_gap_vector(poly_gap_vector&& other) noexcept
+        {
+            move_from(std::move(other));
+        }
+
+        poly_gap_vector& operator=(const poly_gap_vector& other)
+        {
+            if (this != &other)
+            {
+                if (!other.is_copyable())
+                {
+                    throw std::logic_error("Cannot copy poly_gap_vector: "
+                                           "contains non-copyable types");
+                }
+                clear();
+                copy_from(other);
+            }
+            return *this;
+        }
+
+        poly_gap_vector& operator=(poly_gap_vector&& other) noexcept
+        {
+            if (this != &other)
+            {
+                clear();
+                move_from(std::move(other));
+            }
+            return *this;
+        }
+
+        ~poly_gap_vector()
+        {
+            clear();
+        }
+
+        // --- Cursor ---
+
+        // Logical index at which insert() places the next element
+        [[nodiscard]] size_type cursor() const noexcept
+        {
+            return gap_begin_;
+        }
+
+        // Move the gap to a logical position, relocating the elements between
+        // the old and the new cursor
+        void move_cursor(size_type index)
+        {
+            if (index > size())
+            {
+                throw std::out_of_range(
+                    "poly_gap_vector::move_cursor() - index out of bounds");
+            }
+            if (index < gap_begin_)
+            {
+                // Elements [index, gap_begin_) move to the back of the gap
+                const size_type count = gap_begin_ - index;
+                relocate_run(gap_end_ - count, index, count);
+                gap_begin_  = index;
+                gap_end_   -= count;
+            }
+            else if (index > gap_begin_)
+            {
+                // Elements behind the gap move to its front
+                const size_type count = index - gap_begin_;
+                relocate_run(gap_begin_, gap_end_, count);
+                gap_begin_ += count;
+                gap_end_   += count;
+            }
+        }
+
+        // --- Editing at the cursor ---
+
+        // Construct an element at the cursor and advance the cursor past it
+        template <typename Derived, typename... Args>
+            requires FitsInSlot<Derived, Base, SlotSize, Alignment> &&
+                     std::move_constructible<Derived> &&
+                     std::constructible_from<Derived, Args...>
+        Derived* insert(Args&&... args)
+        {
+            if (gap_begin_ == gap_end_)
+            {
+                throw std::out_of_range(
+                    "poly_gap_vector::insert() - capacity exceeded");
+            }
+            std::byte* slot = slot_at(gap_begin_);
+            auto*      obj  = new (slot) Derived(std::forward<Args>(args)...);
+            const Base* base = obj;
+
+            meta_[gap_begin_] = {
+                .ops         = &get_type_ops<Derived>(),
+                .base_offset = static_cast<std::uint32_t>(
+                    reinterpret_cast<const std::byte*>(base) - slot),
+            };
+            count_element(meta_[gap_begin_].ops, 1);
+            ++gap_begin_;
+            return obj;
+        }
+
+        // Move the cursor to index, then insert there
+        template <typename Derived, typename... Args>
+            requires FitsInSlot<Derived, Base, SlotSize, Alignment> &&
+                     std::move_constructible<Derived> &&
+                     std::constructible_from<Derived, Args...>
+        Derived* insert_at(size_type index, Args&&... args)
+        {
+            move_cursor(index);
+            return insert<Derived>(std::forward<Args>(args)...);
+        }
+
+        // Destroy the element before the cursor (backspace)
+        void erase_before()
+        {
+            if (gap_begin_ == 0)
+            {
+                throw std::out_of_range(
+                    "poly_gap_vector::erase_before() - cursor at start");
+            }
+            --gap_begin_;
+            destroy_slot(gap_begin_);
+        }
+
+        // Destroy the element after the cursor (delete)
+        void erase_after()
+        {
+            if (gap_end_ == N)
+            {
+                throw std::out_of_range(
+                    "poly_gap_vector::erase_after() - cursor at end");
+            }
+            destroy_slot(gap_end_);
+            ++gap_end_;
+        }
+
+        // Move the cursor to index and destroy the element there
+        void erase(size_type index)
+        {
+            if (index >= size())
+            {
+                throw std::out_of_range(
+                    "poly_gap_vector::erase() - index out of bounds");
+            }
+            move_cursor(index);
+            erase_after();
+        }
+
+        void clear() noexcept
+        {
+            for (size_type i = 0; i < gap_begin_; ++i)
+            {
+                destroy_slot(i);
+            }
+            for (size_type i = gap_end_; i < N; ++i)
+            {
+                destroy_slot(i);
+            }
+            gap_begin_ = 0;
+            gap_end_   = N;
+        }
+
+        // --- Access by logical index ---
+
+        [[nodiscard]] Base* operator[](size_type index) noexcept
+        {
+            return element(physical(index));
+        }
+        [[nodiscard]] const Base* operator[](size_type index) const noexcept
+        {
+            return element(physical(index));
+        }
+
+        [[nodiscard]] Base* at(size_type index)
+        {
+            check_index(index);
+            return element(physical(index));
+        }
+        [[nodiscard]] const Base* at(size_type index) const
+        {
+            check_index(index);
+            return element(physical(index));
+        }
+
+        template <typename Derived>
+        [[nodiscard]] bool holds(size_type index) const noexcept
+        {
+            return meta_[physical(index)].ops == &get_type_ops<Derived>();
+        }
+
+        // --- Iterators ---
+
+        iterator begin() noexcept
+        {
+            return iterator(this, 0);
+        }
+        iterator end() noexcept
+        {
+            return iterator(this, size());
+        }
+        const_iterator begin() const noexcept
+        {
+            return const_iterator(this, 0);
+        }
+        const_iterator end() const noexcept
+        {
+            return const_iterator(this, size());
+        }
+        const_iterator cbegin() const noexcept
+        {
+            return begin();
+        }
+        const_iterator cend() const noexcept
+        {
+            return end();
+        }
+
+        // --- Capacity ---
+
+        [[nodiscard]] size_type size() const noexcept
+        {
+            return N - (gap_end_ - gap_begin_);
+        }
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+        [[nodiscard]] static constexpr size_type capacity() noexcept
+        {
+            return N;
+        }
+        [[nodiscard]] bool is_copyable() const noexcept
+        {
+            return non_copyable_ == 0;
+        }
+        // Whether cursor moves use a single memmove
+        [[nodiscard]] bool is_trivially_relocatable() const noexcept
+        {
+            return non_trivial_ == 0;
+        }
+
+    private:
+        std::byte* slot_at(size_type physical_index) noexcept
+        {
+            return storage_ + physical_index * SlotSize;
+        }
+        const std::byte* slot_at(size_type physical_index) const noexcept
+        {
+            return storage_ + physical_index * SlotSize;
+        }
+
+        size_type physical(size_type index) const noexcept
+        {
+            return index < gap_begin_ ? index : index + (gap_end_ - gap_begin_);
+        }
+
+        Base* element(size_type physical_index) noexcept
+        {
+            return std::launder(reinterpret_cast<Base*>(
+                slot_at(physical_index) + meta_[physical_index].base_offset));
+        }
+        const Base* element(size_type physical_index) const noexcept
+        {
+            return std::launder(reinterpret_cast<const Base*>(
+                slot_at(physical_index) + meta_[physical_index].base_offset));
+        }
+
+        void check_index(size_type index) const
+        {
+            if (index >= size())
+            {
+                throw std::out_of_range(
+                    "poly_gap_vector::at() - index out of bounds");
+            }
+        }
+
+        void count_element(const type_operations* ops, int delta) noexcept
+        {
+            if (!ops->is_copy_constructible)
+            {
+                non_copyable_ += static_cast<size_type>(delta);
+            }
+            if (!ops->is_trivially_relocatable && !ops->is_trivially_copyable)
+            {
+                non_trivial_ += static_cast<size_type>(delta);
+            }
+        }
+
+        void destroy_slot(size_type physical_index) noexcept
+        {
+            const type_operations* ops = meta_[physical_index].ops;
+            count_element(ops, -1);
+            safe_destroy(slot_at(physical_index), *ops);
+            meta_[physical_index] = {};
+        }
+
+        // Relocate count elements from physical index src to dst; the ranges
+        // may overlap
+        void relocate_run(size_type dst, size_type src, size_type count)
+        {
+            if (count == 0 || dst == src)
+            {
+                return;
+            }
+            if (non_trivial_ == 0)
+            {
+                std::memmove(slot_at(dst), slot_at(src), count * SlotSize);
+            }
+            else if (dst > src)
+            {
+                for (size_type i = count; i > 0; --i)
+                {
+                    safe_relocate(slot_at(dst + i - 1), slot_at(src + i - 1),
+                                  *meta_[src + i - 1].ops);
+                }
+            }
+            else
+            {
+                for (size_type i = 0; i < count; ++i)
+                {
+                    safe_relocate(slot_at(dst + i), slot_at(src + i),
+                                  *meta_[src + i].ops);
+                }
+            }
+            std::memmove(&meta_[dst], &meta_[src], count * sizeof(slot_meta));
+        }
+
+        void copy_from(const poly_gap_vector& other)
+        {
+            if (!other.is_copyable())
+            {
+                throw std::logic_error("Cannot copy poly_gap_vector: "
+                                       "contains non-copyable types");
+            }
+            // Copy into the same physical layout, front part first
+            try
+            {
+                for (size_type i = 0; i < other.gap_begin_; ++i)
+                {
+                    copy_slot(other, i);
+                    ++gap_begin_;
+                }
+                for (size_type i = N; i > other.gap_end_; --i)
+                {
+                    copy_slot(other, i - 1);
+                    --gap_end_;
+                }
+            }
+            catch (...)
+            {
+                clear();
+                throw;
+            }
+        }
+
+        void copy_slot(const poly_gap_vector& other, size_type index)
+        {
+            safe_copy_construct(slot_at(index), other.slot_at(index),
+                                *other.meta_[index].ops);
+            meta_[index] = other.meta_[index];
+            count_element(meta_[index].ops, 1);
+        }
+
+        void move_from(poly_gap_vector&& other) noexcept
+        {
+            for (size_type i = 0; i < other.gap_begin_; ++i)
+            {
+                safe_relocate(slot_at(i), other.slot_at(i), *other.meta_[i].ops);
+            }
+            for (size_type i = other.gap_end_; i < N; ++i)
+            {
+                safe_relocate(slot_at(i), other.slot_at(i), *other.meta_[i].ops);
+            }
+            meta_               = other.meta_;
+            gap_begin_          = other.gap_begin_;
+            gap_end_            = other.gap_end_;
+            non_copyable_       = other.non_copyable_;
+            non_trivial_        = other.non_trivial_;
+            other.meta_         = {};
+            other.gap_begin_    = 0;
+            other.gap_end_      = N;
+            other.non_copyable_ = 0;
+            other.non_trivial_  = 0;
+        }
+    };
+
+    // Convenience alias
+    template <PolymorphicBase Base, size_t N, size_t SlotSize = sizeof(Base),
+              size_t Alignment = alignof(Base)>
+    using gap_vector = poly_gap_vector<Base, N, SlotSize, Alignment>;
+
+} // namespace inline_poly
+
+#endif // INLINE_POLY_GAP_VECTOR_H
@@ -0,0 +1,400 @@
+// Copyright 2025 Dr. Matthias Hölzl
+
+// inline_poly_grid.h - 2D polymorphic grid in Morton-ordered inline storage
+//
+// poly_grid stores one polymorphic cell object per grid position, for tile
+// maps and cellular simulations. A row-major layout puts the cells above and
+// below a position a full row apart; poly_grid instead divides the grid into
+// square tiles of Tile x Tile cells, stores tiles row by row and orders the
+// cells inside each tile along the Z-order (Morton) curve. Cells that are
+// close in 2D are then close in memory, so neighborhood queries and stencil
+// passes touch far fewer cache lines.
+//
+// The slots live in a poly_array, so copy/move and destruction use the usual
+// type_operations machinery. If W or H is not a multiple of Tile, the edge
+// tiles are padded with slots that are never occupied.
+
+#pragma once
+#ifndef INLINE_POLY_GRID_H
+#define INLINE_POLY_GRID_H
+
+#include "inline_poly.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <format>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace inline_poly
+{
+
+    // Neighborhood shapes for poly_grid::for_each_neighbor()
+    enum class neighborhood : std::uint8_t
+    {
+        von_neumann, // 4 orthogonal neighbors
+        moore,       // 8 neighbors including diagonals
+    };
+
+    namespace detail
+    {
+        // Spread the bits of v so that bit i moves to bit 2i
+        constexpr std::size_t morton_spread(std::size_t v) noexcept
+        {
+            std::size_t result = 0;
+            for (std::size_t bit = 0; bit < 16; ++bit)
+            {
+                result |= ((v >> bit) & 1u) << (2 * bit);
+            }
+            return result;
+        }
+
+        // Inverse of morton_spread for the even bits of v
+        constexpr std::size_t morton_compact(std::size_t v) noexcept
+        {
+            std::size_t result = 0;
+            for (std::size_t bit = 0; bit < 16; ++bit)
+            {
+                result |= ((v >> (2 * bit)) & 1u) << bit;
+            }
+            return result;
+        }
+    } // namespace detail
+
+    template <PolymorphicBase Base, size_t W, size_t H,
+              size_t SlotSize = sizeof(Base), size_t Alignment = alignof(Base),
+              size_t Tile = 8>
+    class poly_grid
+    {
+        static_assert(W > 0 && H > 0, "poly_grid needs at least one cell");
+        static_assert(std::has_single_bit(Tile) && Tile <= 256,
+                      "Tile must be a power of two no larger than 256");
+
+        static constexpr size_t tiles_x    = (W + Tile - 1) / Tile;
+        static constexpr size_t tiles_y    = (H + Tile - 1) / Tile;
+        static constexpr size_t tile_cells = Tile * Tile;
+
+    public:
+        using size_type  = size_t;
+        using cells_type = poly_array<Base, tiles_x * tiles_y * tile_cells,
+                                      SlotSize, Alignment>;
+
+        // Number of slots including the padding of partial edge tiles
+        static constexpr size_type slot_count = tiles_x * tiles_y * tile_cells;
+
+        // Rectangular part of a grid, visited in storage order
+        template <typename Grid>
+        class region_view
+        {
+            Grid*     grid_;
+            size_type x_, y_, width_, height_;
+
+        public:
+            region_view(Grid& grid, size_type x, size_type y, size_type width,
+                        size_type height) noexcept :
+                grid_(&grid), x_(x), y_(y), width_(width), height_(height)
+            {}
+
+            [[nodiscard]] size_type x() const noexcept
+            {
+                return x_;
+            }
+            [[nodiscard]] size_type y() const noexcept
+            {
+                return y_;
+            }
+            [[nodiscard]] size_type width() const noexcept
+            {
+                return width_;
+            }
+            [[nodiscard]] size_type height() const noexcept
+            {
+                return height_;
+            }
+
+            [[nodiscard]] bool contains(size_type x, size_type y) const noexcept
+            {
+                return x >= x_ && x < x_ + width_ && y >= y_ && y < y_ + height_;
+            }
+
+            // Call fn(cell, x, y) for every occupied cell in the region. Tiles
+            // are visited row by row, cells inside a tile in Morton order.
+            template <typename Fn>
+            void each(Fn&& fn) const
+            {
+                if (width_ == 0 || height_ == 0)
+                {
+                    return;
+                }
+                const auto inside = [&](auto& cell, size_type x, size_type y)
+                {
+                    if (contains(x, y))
+                    {
+                        fn(cell, x, y);
+                    }
+                };
+                const size_type last_tx = (x_ + width_ - 1) / Tile;
+                const size_type last_ty = (y_ + height_ - 1) / Tile;
+                for (size_type ty = y_ / Tile; ty <= last_ty; ++ty)
+                {
+                    for (size_type tx = x_ / Tile; tx <= last_tx; ++tx)
+                    {
+                        grid_->visit_tile(tx, ty, inside);
+                    }
+                }
+            }
+
+            // Number of occupied cells in the region
+            [[nodiscard]] size_type count() const
+            {
+                size_type n = 0;
+                each([&](auto&, size_type, size_type) { ++n; });
+                return n;
+            }
+        };
+
+    private:
+        cells_type cells_;
+
+        // Morton offset of each in-tile coordinate, pre-spread
+        static constexpr std::array<std::uint32_t, Tile> spread_ = []
+        {
+            std::array<std::uint32_t, Tile> table{};
+            for (size_t i = 0; i < Tile; ++i)
+            {
+                table[i] = static_cast<std::uint32_t>(detail::morton_spread(i));
+            }
+            return table;
+        }();
+
+    public:
+        // Storage index of cell (x, y)
+        [[nodiscard]] static constexpr size_type index_of(size_type x,
+                                                          size_type y) noexcept
+        {
+            const size_type tile = (y / Tile) * tiles_x + x / Tile;
+            return tile * tile_cells + spread_[x % Tile] +
+                   (size_type{spread_[y % Tile]} << 1);
+        }
+
+        // Grid coordinates of a storage index (may lie in edge padding)
+        [[nodiscard]] static constexpr std::pair<size_type, size_type>
+        position_of(size_type index) noexcept
+        {
+            const size_type tile   = index / tile_cells;
+            const size_type within = index % tile_cells;
+            const size_type x      = detail::morton_compact(within);
+            const size_type y      = detail::morton_compact(within >> 1);
+            return {(tile % tiles_x) * Tile + x, (tile / tiles_x) * Tile + y};
+        }
+
+        [[nodiscard]] static constexpr bool contains(size_type x,
+                                                     size_type y) noexcept
+        {
+            return x < W && y < H;
+        }
+
+        // --- Modifiers ---
+
+        // Construct a cell object at (x, y), replacing any previous one
+        template <typename Derived, typename... Args>
+            requires FitsInSlot<Derived, Base, SlotSize, Alignment> &&
+                     std::constructible_from<Derived, Args...>
+        Derived* emplace(size_type x, size_type y, Args&&... args)
+        {
+            check_position(x, y, "emplace");
+            return cells_.template emplace<Derived>(index_of(x, y),
+                                                    std::forward<Args>(args)...);
+        }
+
+        void clear() noexcept
+        {
+            cells_.clear();
+        }
+
+        // --- Access ---
+
+        // The cell object at (x, y) or nullptr if the cell is empty
+        [[nodiscard]] Base* at(size_type x, size_type y)
+        {
+            check_position(x, y, "at");
+            return cells_[index_of(x, y)];
+        }
+        [[nodiscard]] const Base* at(size_type x, size_type y) const
+        {
+            check_position(x, y, "at");
+            return cells_[index_of(x, y)];
+        }
+
+        // Unchecked access
+        [[nodiscard]] Base* operator()(size_type x, size_type y) noexcept
+        {
+            return cells_[index_of(x, y)];
+        }
+        [[nodiscard]] const Base* operator()(size_type x,
+                                             size_type y) const noexcept
+        {
+            return cells_[index_of(x, y)];
+        }
+
+        // Call fn(cell, x, y) for every occupied cell in storage order
+        template <typename Fn>
+        void for_each(Fn&& fn)
+        {
+            region().each(std::forward<Fn>(fn));
+        }
+        template <typename Fn>
+        void for_each(Fn&& fn) const
+        {
+            region().each(std::forward<Fn>(fn));
+        }
+
+        // Call fn(neighbor, nx, ny) for each occupied in-bounds neighbor
+        template <typename Fn>
+        void for_each_neighbor(size_type x, size_type y, Fn&& fn,
+                               neighborhood shape = neighborhood::moore)
+        {
+            check_position(x, y, "for_each_neighbor");
+            for (int dy = -1; dy <= 1; ++dy)
+            {
+                for (int dx = -1; dx <= 1; ++dx)
+                {
+                    if ((dx == 0 && dy == 0) ||
+                        (shape == neighborhood::von_neumann && dx != 0 &&
+                         dy != 0))
+                    {
+                        continue;
+                    }
+                    // Wraps below zero, which contains() rejects
+                    const size_type nx = x + static_cast<size_type>(dx);
+                    const size_type ny = y + static_cast<size_type>(dy);
+                    if (!contains(nx, ny))
+                    {
+                        continue;
+                    }
+                    if (Base* cell = cells_[index_of(nx, ny)])
+                    {
+                        fn(*cell, nx, ny);
+                    }
+                }
+            }
+        }
+
+        // View of the rectangle [x, x + width) x [y, y + height), clipped to
+        // the grid
+        [[nodiscard]] region_view<poly_grid> region(size_type x, size_type y,
+                                                    size_type width,
+                                                    size_type height)
+        {
+            return make_region<poly_grid>(*this, x, y, width, height);
+        }
+        [[nodiscard]] region_view<const poly_grid>
+        region(size_type x, size_type y, size_type width,
+               size_type height) const
+        {
+            return make_region<const poly_grid>(*this, x, y, width, height);
+        }
+
+        // View of the whole grid
+        [[nodiscard]] region_view<poly_grid> region() noexcept
+        {
+            return {*this, 0, 0, W, H};
+        }
+        [[nodiscard]] region_view<const poly_grid> region() const noexcept
+        {
+            return {*this, 0, 0, W, H};
+        }
+
+        [[nodiscard]] static constexpr size_type width() noexcept
+        {
+            return W;
+        }
+        [[nodiscard]] static constexpr size_type height() noexcept
+        {
+            return H;
+        }
+        [[nodiscard]] static constexpr size_type tile_size() noexcept
+        {
+            return Tile;
+        }
+
+        [[nodiscard]] bool is_copyable() const noexcept
+        {
+            return cells_.is_copyable();
+        }
+
+        // Underlying slots in storage order
+        [[nodiscard]] cells_type& cells() noexcept
+        {
+            return cells_;
+        }
+        [[nodiscard]] const cells_type& cells() const noexcept
+        {
+            return cells_;
+        }
+
+    private:
+        void check_position(size_type x, size_type y, const char* fn) const
+        {
+            if (!contains(x, y))
+            {
+                throw std::out_of_range(std::format(
+                    "poly_grid::{}({}, {}) out of bounds", fn, x, y));
+            }
+        }
+
+        template <typename Grid>
+        static region_view<Grid> make_region(Grid& grid, size_type x,
+                                             size_type y, size_type width,
+                                             size_type height) noexcept
+        {
+            x      = std::min(x, W);
+            y      = std::min(y, H);
+            width  = std::min(width, W - x);
+            height = std::min(height, H - y);
+            return {grid, x, y, width, height};
+        }
+
+        // Call fn(cell, x, y) for the occupied cells of one tile in Morton
+        // order
+        template <typename Fn>
+        void visit_tile(size_type tx, size_type ty, Fn&& fn)
+        {
+            visit_tile_impl(*this, tx, ty, fn);
+        }
+        template <typename Fn>
+        void visit_tile(size_type tx, size_type ty, Fn&& fn) const
+        {
+            visit_tile_impl(*this, tx, ty, fn);
+        }
+
+        template <typename Grid, typename Fn>
+        static void visit_tile_impl(Grid& grid, size_type tx, size_type ty,
+                                    Fn& fn)
+        {
+            const size_type first = (ty * tiles_x + tx) * tile_cells;
+            for (size_type i = first; i < first + tile_cells; ++i)
+            {
+                using cell_type =
+                    std::conditional_t<std::is_const_v<Grid>, const Base, Base>;
+                if (cell_type* cell = grid.cells_[i])
+                {
+                    const auto [x, y] = position_of(i);
+                    fn(*cell, x, y);
+                }
+            }
+        }
+    };
+
+    // Convenience alias
+    template <PolymorphicBase Base, size_t W, size_t H,
+              size_t SlotSize = sizeof(Base), size_t Alignment = alignof(Base),
+              size_t Tile = 8>
+    using grid = poly_grid<Base, W, H, SlotSize, Alignment, Tile>;
+
+} // namespace inline_poly
+
+#endif // INLINE_POLY_GRID_H
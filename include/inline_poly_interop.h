@@ -0,0 +1,151 @@
+// Copyright 2025 Dr. Matthias Hölzl
+
+// inline_poly_interop.h - Bulk conversion from and to unique_ptr collections
+//
+// Code that owns its objects as std::vector<std::unique_ptr<Base>> can move
+// them into an inline container with adopt_from() and back out with
+// export_to(), so a subsystem can be converted and measured without changing
+// the producers and consumers around it.
+//
+// The container has to construct each object as its exact dynamic type, so
+// the candidate types are registered in a type_list; all of them must fit the
+// container's slots. Every object is matched by typeid() against the list,
+// move constructed into an inline slot (or a new heap object) and its old
+// storage is released.
+//
+//     using Shapes = inline_poly::type_list<Circle, Rectangle>;
+//     inline_poly::adopt_from<Shapes>(shapes, legacy_shapes);
+//     inline_poly::export_to<Shapes>(shapes, std::back_inserter(legacy));
+
+#pragma once
+#ifndef INLINE_POLY_INTEROP_H
+#define INLINE_POLY_INTEROP_H
+
+#include "inline_poly.h"
+
+#include <cstddef>
+#include <memory>
+#include <ranges>
+#include <stdexcept>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+
+namespace inline_poly
+{
+
+    namespace detail
+    {
+        template <typename TypeList>
+        struct exact_type_dispatch;
+
+        // Calls fn(std::type_identity<T>{}) for the registered T whose typeid
+        // equals that of obj; returns false if no type matches
+        template <typename... Types>
+        struct exact_type_dispatch<type_list<Types...>>
+        {
+            template <typename Base, typename Fn>
+            static bool visit(const Base& obj, Fn&& fn)
+            {
+                const std::type_info& dynamic_type = typeid(obj);
+                return ((typeid(Types) == dynamic_type
+                             ? (fn(std::type_identity<Types>{}), true)
+                             : false) ||
+                        ...);
+            }
+
+            template <typename Base>
+            static bool contains(const Base& obj)
+            {
+                return visit(obj, [](auto) {});
+            }
+        };
+
+        template <typename Container>
+        using container_base_t =
+            std::remove_pointer_t<typename Container::value_type>;
+    } // namespace detail
+
+    // Move every object owned by the unique_ptrs in source into dst, in
+    // order, and release the heap objects; the pointers are left null.
+    // Throws std::invalid_argument for a null pointer or an unregistered
+    // dynamic type and std::out_of_range if dst lacks capacity, in both
+    // cases before anything is moved. Returns the number of adopted objects.
+    template <typename Types, typename Container, std::ranges::range Range>
+    std::size_t adopt_from(Container& dst, Range&& source)
+    {
+        using dispatch = detail::exact_type_dispatch<Types>;
+
+        std::size_t count = 0;
+        for (const auto& ptr : source)
+        {
+            if (!ptr)
+            {
+                throw std::invalid_argument("adopt_from() - null pointer");
+            }
+            if (!dispatch::contains(*ptr))
+            {
+                throw std::invalid_argument(
+                    "adopt_from() - unregistered dynamic type");
+            }
+            ++count;
+        }
+        if (count > dst.capacity() - dst.size())
+        {
+            throw std::out_of_range("adopt_from() - capacity exceeded");
+        }
+
+        for (auto& ptr : source)
+        {
+            dispatch::visit(*ptr,
+                            [&]<typename T>(std::type_identity<T>)
+                            {
+                                dst.template emplace_back<T>(
+                                    std::move(static_cast<T&>(*ptr)));
+                            });
+            ptr.reset();
+        }
+        return count;
+    }
+
+    // Move every object of src into a new heap object, write the owning
+    // std::unique_ptr<Base> to out in container order and clear src. Empty
+    // slots are skipped.
+    // Throws std::invalid_argument before anything is moved if an element's
+    // type is not registered. Returns the advanced output iterator.
+    template <typename Types, typename Container, typename OutputIt>
+    OutputIt export_to(Container& src, OutputIt out)
+    {
+        using dispatch = detail::exact_type_dispatch<Types>;
+        using Base     = detail::container_base_t<Container>;
+
+        for (const Base* obj : src)
+        {
+            if (obj && !dispatch::contains(*obj))
+            {
+                throw std::invalid_argument(
+                    "export_to() - unregistered dynamic type");
+            }
+        }
+
+        for (Base* obj : src)
+        {
+            if (!obj)
+            {
+                continue; // Empty or erased slot
+            }
+            dispatch::visit(*obj,
+                            [&]<typename T>(std::type_identity<T>)
+                            {
+                                *out = std::unique_ptr<Base>(
+                                    new T(std::move(static_cast<T&>(*obj))));
+                                ++out;
+                            });
+        }
+        src.clear();
+        return out;
+    }
+
+} // namespace inline_poly
+
+#endif // INLINE_POLY_INTEROP_H
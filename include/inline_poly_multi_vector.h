@@ -0,0 +1,651 @@
+// Copyright 2025 Dr. Matthias Hölzl
+
+// inline_poly_multi_vector.h - Polymorphic vector with several slot sizes
+//
+// poly_vector sizes every slot for the largest type. When a hierarchy has a
+// bimodal size distribution, poly_multi_vector keeps one inline pool per size
+// class instead; each Derived is placed in the smallest class it fits at
+// compile time. A separate index of element pointers preserves insertion
+// order across the pools, so indexing and iteration behave like a single
+// vector, and inserting or erasing only shifts that index - objects never move.
+
+#pragma once
+#ifndef INLINE_POLY_MULTI_VECTOR_H
+#define INLINE_POLY_MULTI_VECTOR_H
+
+#include "inline_poly.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+
+namespace inline_poly
+{
+
+    // One pool of a poly_multi_vector: Count slots of SlotSize bytes each
+    template <std::size_t SlotSize, std::size_t Count,
+              std::size_t Alignment = alignof(std::max_align_t)>
+    struct size_class
+    {
+        static constexpr std::size_t slot_size = SlotSize;
+        static constexpr std::size_t count     = Count;
+        static constexpr std::size_t alignment = Alignment;
+    };
+
+    template <PolymorphicBase Base, typename... SizeClasses>
+    class poly_multi_vector
+    {
+        static_assert(sizeof...(SizeClasses) >= 1 &&
+                          sizeof...(SizeClasses) <= 8,
+                      "poly_multi_vector needs one to eight size classes");
+
+        static constexpr std::size_t class_count = sizeof...(SizeClasses);
+
+        static constexpr std::array<std::size_t, class_count> slot_sizes = {
+            SizeClasses::slot_size...};
+        static constexpr std::array<std::size_t, class_count> slot_counts = {
+            SizeClasses::count...};
+        static constexpr std::array<std::size_t, class_count> slot_alignments = {
+            SizeClasses::alignment...};
+
+        static_assert(std::is_sorted(slot_sizes.begin(), slot_sizes.end()),
+                      "size classes must be ordered by ascending slot size");
+        static_assert(((SizeClasses::slot_size >= sizeof(Base)) && ...),
+                      "every slot size must hold Base");
+        static_assert(((SizeClasses::alignment >= alignof(Base)) && ...),
+                      "every alignment must be at least alignof(Base)");
+        static_assert(
+            ((SizeClasses::slot_size % SizeClasses::alignment == 0) && ...),
+            "slot sizes must be multiples of their alignment");
+
+        // Byte offset of each pool in the shared storage, aligned per class
+        static constexpr std::array<std::size_t, class_count + 1> pool_offsets =
+            []
+        {
+            std::array<std::size_t, class_count + 1> offsets{};
+            std::size_t                              offset = 0;
+            for (std::size_t c = 0; c < class_count; ++c)
+            {
+                offset = (offset + slot_alignments[c] - 1) / slot_alignments[c] *
+                         slot_alignments[c];
+                offsets[c] = offset;
+                offset    += slot_sizes[c] * slot_counts[c];
+            }
+            offsets[class_count] = offset;
+            return offsets;
+        }();
+
+        // First index of each pool's segment in the shared free-slot array
+        static constexpr std::array<std::size_t, class_count> free_offsets = []
+        {
+            std::array<std::size_t, class_count> offsets{};
+            for (std::size_t c = 1; c < class_count; ++c)
+            {
+                offsets[c] = offsets[c - 1] + slot_counts[c - 1];
+            }
+            return offsets;
+        }();
+
+        static constexpr std::size_t storage_alignment =
+            std::max({SizeClasses::alignment...});
+
+    public:
+        static constexpr std::size_t Capacity = (SizeClasses::count + ...);
+
+        // Typedefs for STL compatibility
+        using value_type             = Base*;
+        using size_type              = size_t;
+        using difference_type        = std::ptrdiff_t;
+        using pointer                = Base**;
+        using const_pointer          = Base* const*;
+        using reference              = Base*&;
+        using const_reference        = Base* const&;
+        using iterator               = Base**;
+        using const_iterator         = Base* const*;
+        using reverse_iterator       = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        // Index of the size class a Derived is placed in by default
+        template <typename Derived>
+        static constexpr std::size_t class_for = []
+        {
+            for (std::size_t c = 0; c < class_count; ++c)
+            {
+                if (sizeof(Derived) <= slot_sizes[c] &&
+                    alignof(Derived) <= slot_alignments[c])
+                {
+                    return c;
+                }
+            }
+            return class_count;
+        }();
+
+        template <typename Derived>
+        static constexpr bool fits =
+            std::derived_from<Derived, Base> && class_for<Derived> < class_count;
+
+    private:
+        // Placement of an element: its type operations and its pool slot
+        struct slot_meta
+        {
+            const type_operations* ops  = nullptr;
+            std::uint32_t          slot = 0;
+            std::uint8_t           pool = 0;
+        };
+
+        alignas(storage_alignment)
+            std::byte storage_[pool_offsets[class_count]]{};
+
+        // Insertion-ordered element index, kept as two parallel arrays so that
+        // iteration walks a dense array of Base*
+        std::array<Base*, Capacity>     ptrs_{};
+        std::array<slot_meta, Capacity> meta_{};
+        size_t                          size_ = 0;
+
+        // Per-pool stacks of free slot indices, stored back to back
+        std::array<std::uint32_t, Capacity>  free_slots_{};
+        std::array<std::size_t, class_count> free_count_{};
+
+        // Number of elements lacking copy/move support; the container is
+        // copyable (movable) while the respective count is zero
+        size_t non_copyable_ = 0;
+        size_t non_movable_  = 0;
+
+    public:
+        poly_multi_vector() noexcept
+        {
+            reset_free_lists();
+        }
+
+        poly_multi_vector(const poly_multi_vector& other)
+        {
+            if (!other.is_copyable())
+            {
+                throw std::logic_error(
+                    "Cannot copy poly_multi_vector: contains non-copyable types");
+            }
+            reset_free_lists();
+            copy_from(other);
+        }
+
+        poly_multi_vector(poly_multi_vector&& other) noexcept
+        {
+            reset_free_lists();
+            move_from(std::move(other));
+        }
+
+        poly_multi_vector& operator=(const poly_multi_vector& other)
+        {
+            if (!other.is_copyable())
+            {
+                throw std::logic_error(
+                    "Cannot copy poly_multi_vector: contains non-copyable types");
+            }
+            if (this != &other)
+            {
+                clear();
+                copy_from(other);
+            }
+            return *this;
+        }
+
+        poly_multi_vector& operator=(poly_multi_vector&& other) noexcept
+        {
+            if (this != &other)
+            {
+                clear();
+                move_from(std::move(other));
+            }
+            return *this;
+        }
+
+        ~poly_multi_vector()
+        {
+            clear();
+        }
+
+        // --- Core Functionality ---
+
+        template <typename Derived, typename... Args>
+            requires fits<Derived> && std::constructible_from<Derived, Args...>
+        Derived* emplace_back(Args&&... args)
+        {
+            return construct_at<Derived>(size_, std::forward<Args>(args)...);
+        }
+
+        template <typename Derived>
+            requires fits<Derived> && std::copy_constructible<Derived>
+        void push_back(const Derived& value)
+        {
+            emplace_back<Derived>(value);
+        }
+
+        template <typename Derived>
+            requires fits<std::remove_cvref_t<Derived>> &&
+                     std::move_constructible<std::remove_cvref_t<Derived>>
+        void push_back(Derived&& value)
+        {
+            emplace_back<std::remove_cvref_t<Derived>>(
+                std::forward<Derived>(value));
+        }
+
+        template <typename Derived, typename... Args>
+            requires fits<Derived> && std::constructible_from<Derived, Args...>
+        iterator emplace(const_iterator pos, Args&&... args)
+        {
+            const auto index = static_cast<size_type>(pos - ptrs_.data());
+            if (index > size_)
+            {
+                throw std::out_of_range(
+                    "poly_multi_vector::emplace() - invalid position");
+            }
+            construct_at<Derived>(index, std::forward<Args>(args)...);
+            return ptrs_.data() + index;
+        }
+
+        void pop_back()
+        {
+            if (size_ == 0)
+            {
+                throw std::out_of_range(
+                    "poly_multi_vector::pop_back() - vector is empty");
+            }
+            release(size_ - 1);
+            --size_;
+        }
+
+        iterator erase(const_iterator pos)
+        {
+            return erase(pos, pos + 1);
+        }
+
+        // Elements never move, so erasing works for any contained type and
+        // only shifts the pointer index
+        iterator erase(const_iterator first, const_iterator last)
+        {
+            const auto first_index =
+                static_cast<size_type>(first - ptrs_.data());
+            const auto last_index = static_cast<size_type>(last - ptrs_.data());
+            if (first_index > last_index || last_index > size_)
+            {
+                throw std::out_of_range(
+                    "poly_multi_vector::erase() - invalid range");
+            }
+
+            for (size_type i = first_index; i < last_index; ++i)
+            {
+                release(i);
+            }
+            std::move(ptrs_.begin() + last_index, ptrs_.begin() + size_,
+                      ptrs_.begin() + first_index);
+            std::move(meta_.begin() + last_index, meta_.begin() + size_,
+                      meta_.begin() + first_index);
+            size_ -= last_index - first_index;
+            return ptrs_.data() + first_index;
+        }
+
+        void clear() noexcept
+        {
+            for (size_type i = 0; i < size_; ++i)
+            {
+                release(i);
+            }
+            size_ = 0;
+        }
+
+        // --- Element Access ---
+
+        reference operator[](size_type index) noexcept
+        {
+            assert(index < size_);
+            return ptrs_[index];
+        }
+
+        const_reference operator[](size_type index) const noexcept
+        {
+            assert(index < size_);
+            return ptrs_[index];
+        }
+
+        reference at(size_type index)
+        {
+            if (index >= size_)
+            {
+                throw std::out_of_range(
+                    "poly_multi_vector::at() - index out of bounds");
+            }
+            return ptrs_[index];
+        }
+
+        const_reference at(size_type index) const
+        {
+            if (index >= size_)
+            {
+                throw std::out_of_range(
+                    "poly_multi_vector::at() - index out of bounds");
+            }
+            return ptrs_[index];
+        }
+
+        reference front()
+        {
+            return at(0);
+        }
+        const_reference front() const
+        {
+            return at(0);
+        }
+        reference back()
+        {
+            if (size_ == 0)
+            {
+                throw std::out_of_range(
+                    "poly_multi_vector::back() - vector is empty");
+            }
+            return ptrs_[size_ - 1];
+        }
+        const_reference back() const
+        {
+            if (size_ == 0)
+            {
+                throw std::out_of_range(
+                    "poly_multi_vector::back() - vector is empty");
+            }
+            return ptrs_[size_ - 1];
+        }
+
+        // Size class an element was placed in
+        [[nodiscard]] std::size_t class_of(size_type index) const
+        {
+            if (index >= size_)
+            {
+                throw std::out_of_range(
+                    "poly_multi_vector::class_of() - index out of bounds");
+            }
+            return meta_[index].pool;
+        }
+
+        // --- Iterators ---
+
+        iterator begin() noexcept
+        {
+            return ptrs_.data();
+        }
+        const_iterator begin() const noexcept
+        {
+            return ptrs_.data();
+        }
+        const_iterator cbegin() const noexcept
+        {
+            return begin();
+        }
+        iterator end() noexcept
+        {
+            return ptrs_.data() + size_;
+        }
+        const_iterator end() const noexcept
+        {
+            return ptrs_.data() + size_;
+        }
+        const_iterator cend() const noexcept
+        {
+            return end();
+        }
+        reverse_iterator rbegin() noexcept
+        {
+            return reverse_iterator(end());
+        }
+        const_reverse_iterator rbegin() const noexcept
+        {
+            return const_reverse_iterator(end());
+        }
+        reverse_iterator rend() noexcept
+        {
+            return reverse_iterator(begin());
+        }
+        const_reverse_iterator rend() const noexcept
+        {
+            return const_reverse_iterator(begin());
+        }
+
+        pointer data() noexcept
+        {
+            return ptrs_.data();
+        }
+        const_pointer data() const noexcept
+        {
+            return ptrs_.data();
+        }
+
+        // --- Capacity ---
+
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return size_ == 0;
+        }
+        [[nodiscard]] size_type size() const noexcept
+        {
+            return size_;
+        }
+        [[nodiscard]] static constexpr size_type max_size() noexcept
+        {
+            return Capacity;
+        }
+        [[nodiscard]] static constexpr size_type capacity() noexcept
+        {
+            return Capacity;
+        }
+
+        // Number of slots in a size class and how many of them are in use
+        [[nodiscard]] static constexpr size_type class_capacity(std::size_t c)
+        {
+            return slot_counts[c];
+        }
+        [[nodiscard]] size_type class_size(std::size_t c) const noexcept
+        {
+            return slot_counts[c] - free_count_[c];
+        }
+        [[nodiscard]] static constexpr std::size_t slot_size(std::size_t c)
+        {
+            return slot_sizes[c];
+        }
+
+        // Bytes of inline object storage across all pools
+        [[nodiscard]] static constexpr std::size_t storage_bytes() noexcept
+        {
+            return pool_offsets[class_count];
+        }
+
+        // --- Query Capabilities ---
+
+        [[nodiscard]] bool is_copyable() const noexcept
+        {
+            return non_copyable_ == 0;
+        }
+        [[nodiscard]] bool is_movable() const noexcept
+        {
+            return non_movable_ == 0;
+        }
+
+    private:
+        void* slot_address(std::size_t pool, std::size_t slot) noexcept
+        {
+            return &storage_[pool_offsets[pool] + slot * slot_sizes[pool]];
+        }
+
+        const void* slot_address(std::size_t pool,
+                                 std::size_t slot) const noexcept
+        {
+            return &storage_[pool_offsets[pool] + slot * slot_sizes[pool]];
+        }
+
+        void reset_free_lists() noexcept
+        {
+            for (std::size_t c = 0; c < class_count; ++c)
+            {
+                // Pop order hands out the lowest slots first
+                for (std::size_t s = 0; s < slot_counts[c]; ++s)
+                {
+                    free_slots_[free_offsets[c] + s] =
+                        static_cast<std::uint32_t>(slot_counts[c] - 1 - s);
+                }
+                free_count_[c] = slot_counts[c];
+            }
+        }
+
+        // Pick a free slot in the smallest class that fits, falling back to
+        // larger classes when it is exhausted
+        bool acquire_slot(std::size_t first_class, std::size_t size,
+                          std::size_t alignment, slot_meta& meta) noexcept
+        {
+            for (std::size_t c = first_class; c < class_count; ++c)
+            {
+                if (free_count_[c] != 0 && size <= slot_sizes[c] &&
+                    alignment <= slot_alignments[c])
+                {
+                    meta.pool = static_cast<std::uint8_t>(c);
+                    meta.slot = free_slots_[free_offsets[c] + --free_count_[c]];
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void track(const type_operations& ops, std::ptrdiff_t delta) noexcept
+        {
+            if (!ops.is_copy_constructible)
+            {
+                non_copyable_ += static_cast<size_t>(delta);
+            }
+            if (!ops.is_move_constructible)
+            {
+                non_movable_ += static_cast<size_t>(delta);
+            }
+        }
+
+        void push_free(const slot_meta& meta) noexcept
+        {
+            free_slots_[free_offsets[meta.pool] + free_count_[meta.pool]++] =
+                meta.slot;
+        }
+
+        template <typename Derived, typename... Args>
+        Derived* construct_at(size_type index, Args&&... args)
+        {
+            if (size_ >= Capacity)
+            {
+                throw std::out_of_range("poly_multi_vector - capacity exceeded");
+            }
+
+            const auto& ops = get_type_ops<Derived>();
+            slot_meta   meta{.ops = &ops};
+            if (!acquire_slot(class_for<Derived>, sizeof(Derived),
+                              alignof(Derived), meta))
+            {
+                throw std::out_of_range(
+                    "poly_multi_vector - no free slot large enough");
+            }
+
+            Derived* obj;
+            try
+            {
+                obj = new (slot_address(meta.pool, meta.slot))
+                    Derived(std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                push_free(meta);
+                throw;
+            }
+
+            std::move_backward(ptrs_.begin() + index, ptrs_.begin() + size_,
+                               ptrs_.begin() + size_ + 1);
+            std::move_backward(meta_.begin() + index, meta_.begin() + size_,
+                               meta_.begin() + size_ + 1);
+            ptrs_[index] = obj;
+            meta_[index] = meta;
+            ++size_;
+            track(ops, 1);
+            return obj;
+        }
+
+        // Destroy an element and return its slot; the index is left to the
+        // caller
+        void release(size_type index) noexcept
+        {
+            const slot_meta& meta = meta_[index];
+            safe_destroy(ptrs_[index], *meta.ops);
+            push_free(meta);
+            track(*meta.ops, -1);
+            ptrs_[index] = nullptr;
+        }
+
+        // Objects keep their pool and slot, so the free lists carry over. If
+        // a copy throws, the elements copied so far are destroyed and the
+        // vector is left empty.
+        void copy_from(const poly_multi_vector& other)
+        {
+            free_slots_ = other.free_slots_;
+            free_count_ = other.free_count_;
+            try
+            {
+                for (size_type i = 0; i < other.size_; ++i)
+                {
+                    const slot_meta& meta = other.meta_[i];
+                    void*            dst  = slot_address(meta.pool, meta.slot);
+                    safe_copy_construct(dst,
+                                        other.slot_address(meta.pool, meta.slot),
+                                        *meta.ops);
+                    ptrs_[i] = rebase(other.ptrs_[i], other, meta, dst);
+                    meta_[i] = meta;
+                    ++size_;
+                    track(*meta.ops, 1);
+                }
+            }
+            catch (...)
+            {
+                clear();
+                reset_free_lists();
+                throw;
+            }
+        }
+
+        void move_from(poly_multi_vector&& other) noexcept
+        {
+            for (size_type i = 0; i < other.size_; ++i)
+            {
+                const slot_meta& meta = other.meta_[i];
+                void*            dst  = slot_address(meta.pool, meta.slot);
+                safe_move_construct(
+                    dst, other.slot_address(meta.pool, meta.slot), *meta.ops);
+                ptrs_[i] = rebase(other.ptrs_[i], other, meta, dst);
+                meta_[i] = meta;
+                track(*meta.ops, 1);
+            }
+            size_       = other.size_;
+            free_slots_ = other.free_slots_;
+            free_count_ = other.free_count_;
+            other.clear();
+        }
+
+        // Translate a Base* into the equivalent pointer for a copy of the
+        // object at dst (Base need not sit at offset zero of Derived)
+        static Base* rebase(Base* src_ptr, const poly_multi_vector& src,
+                            const slot_meta& meta, void* dst) noexcept
+        {
+            const auto* src_slot = static_cast<const std::byte*>(
+                src.slot_address(meta.pool, meta.slot));
+            const auto offset =
+                reinterpret_cast<const std::byte*>(src_ptr) - src_slot;
+            return reinterpret_cast<Base*>(static_cast<std::byte*>(dst) + offset);
+        }
+    };
+
+    template <PolymorphicBase Base, typename... SizeClasses>
+    using multi_vector = poly_multi_vector<Base, SizeClasses...>;
+
+} // namespace inline_poly
+
+#endif // INLINE_POLY_MULTI_VECTOR_H
@@ -0,0 +1,604 @@
+// Copyright 2025 Dr. Matthias Hölzl
+
+// inline_poly_scheduler.h - Parallel system scheduler with declared access
+//
+// Systems declare which component types or container instances they read and
+// write. Every frame the scheduler derives a dependency DAG from those
+// declarations (a system waits for each earlier-registered system it
+// conflicts with) and runs independent systems concurrently on a
+// work-stealing thread pool. Inside a system, parallel_for() and for_each()
+// split a range or a container's slots into chunks on the same pool. Threads
+// that wait for work help execute it, so nested parallelism cannot deadlock
+// and no manual locking is needed for correctly declared access.
+//
+// Unlike the containers, the scheduler allocates: task queues and the system
+// table live on the heap.
+
+#pragma once
+#ifndef INLINE_POLY_SCHEDULER_H
+#define INLINE_POLY_SCHEDULER_H
+
+#include "inline_poly.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace inline_poly
+{
+
+    // =============================================================================
+    // Work-Stealing Pool
+    // =============================================================================
+
+    // Each worker owns a deque: it pushes and pops at the back, idle workers
+    // steal from the front of other deques. Tasks submitted from outside the
+    // pool go to a shared injection queue. A pool with zero workers is valid;
+    // tasks then run on whichever thread calls run_pending_task().
+    class work_stealing_pool
+    {
+    public:
+        using task = std::function<void()>;
+
+        explicit work_stealing_pool(
+            std::size_t workers = default_worker_count()) :
+            queues_(workers + 1)
+        {
+            for (auto& queue : queues_)
+            {
+                queue = std::make_unique<task_queue>();
+            }
+            threads_.reserve(workers);
+            for (std::size_t i = 0; i < workers; ++i)
+            {
+                threads_.emplace_back([this, i] { worker_loop(i); });
+            }
+        }
+
+        work_stealing_pool(const work_stealing_pool&)            = delete;
+        work_stealing_pool& operator=(const work_stealing_pool&) = delete;
+
+        ~work_stealing_pool()
+        {
+            {
+                std::lock_guard lock(sleep_mutex_);
+                stop_ = true;
+            }
+            wake_.notify_all();
+            for (auto& thread : threads_)
+            {
+                thread.join();
+            }
+        }
+
+        void submit(task t)
+        {
+            const std::size_t index =
+                current_pool() == this ? current_index() : injection_queue();
+            // Count first so a concurrent take() never sees an uncounted task
+            {
+                std::lock_guard lock(sleep_mutex_);
+                ++pending_;
+            }
+            {
+                std::lock_guard lock(queues_[index]->mutex);
+                queues_[index]->tasks.push_back(std::move(t));
+            }
+            wake_.notify_one();
+        }
+
+        // Run one queued task on the calling thread. Returns false if no task
+        // was available.
+        bool run_pending_task()
+        {
+            task t;
+            const std::size_t home =
+                current_pool() == this ? current_index() : injection_queue();
+            if (!take(home, t))
+            {
+                return false;
+            }
+            t();
+            return true;
+        }
+
+        [[nodiscard]] std::size_t worker_count() const noexcept
+        {
+            return threads_.size();
+        }
+
+        static std::size_t default_worker_count() noexcept
+        {
+            const unsigned hardware = std::thread::hardware_concurrency();
+            return hardware > 1 ? hardware - 1 : 0; // The caller helps
+        }
+
+    private:
+        struct task_queue
+        {
+            std::mutex       mutex;
+            std::deque<task> tasks;
+        };
+
+        std::vector<std::unique_ptr<task_queue>> queues_;
+        std::vector<std::thread>                 threads_;
+        std::mutex                               sleep_mutex_;
+        std::condition_variable                  wake_;
+        std::size_t                              pending_ = 0;
+        bool                                     stop_    = false;
+
+        std::size_t injection_queue() const noexcept
+        {
+            return queues_.size() - 1;
+        }
+
+        static const work_stealing_pool*& current_pool() noexcept
+        {
+            thread_local const work_stealing_pool* pool = nullptr;
+            return pool;
+        }
+
+        static std::size_t& current_index() noexcept
+        {
+            thread_local std::size_t index = 0;
+            return index;
+        }
+
+        // Pop from the back of the home queue, otherwise steal from the
+        // front of the others (starting after home to spread contention)
+        bool take(std::size_t home, task& out)
+        {
+            {
+                task_queue&     own = *queues_[home];
+                std::lock_guard lock(own.mutex);
+                if (!own.tasks.empty())
+                {
+                    out = std::move(own.tasks.back());
+                    own.tasks.pop_back();
+                    return claimed();
+                }
+            }
+            for (std::size_t n = 1; n < queues_.size(); ++n)
+            {
+                task_queue&     victim = *queues_[(home + n) % queues_.size()];
+                std::lock_guard lock(victim.mutex);
+                if (!victim.tasks.empty())
+                {
+                    out = std::move(victim.tasks.front());
+                    victim.tasks.pop_front();
+                    return claimed();
+                }
+            }
+            return false;
+        }
+
+        bool claimed()
+        {
+            std::lock_guard lock(sleep_mutex_);
+            --pending_;
+            return true;
+        }
+
+        void worker_loop(std::size_t index)
+        {
+            current_pool()  = this;
+            current_index() = index;
+            for (;;)
+            {
+                task t;
+                if (take(index, t))
+                {
+                    t();
+                    continue;
+                }
+                std::unique_lock lock(sleep_mutex_);
+                wake_.wait(lock, [this] { return stop_ || pending_ > 0; });
+                if (stop_)
+                {
+                    return;
+                }
+            }
+        }
+    };
+
+    // Counts outstanding tasks; wait() helps the pool until all are done
+    class task_group
+    {
+    public:
+        explicit task_group(work_stealing_pool& pool) noexcept : pool_(pool) {}
+
+        task_group(const task_group&)            = delete;
+        task_group& operator=(const task_group&) = delete;
+
+        ~task_group()
+        {
+            wait_for_completion();
+        }
+
+        template <typename Fn>
+        void run(Fn&& fn)
+        {
+            outstanding_.fetch_add(1, std::memory_order_relaxed);
+            pool_.submit(
+                [this, fn = std::forward<Fn>(fn)]() mutable
+                {
+                    try
+                    {
+                        fn();
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard lock(error_mutex_);
+                        if (!error_)
+                        {
+                            error_ = std::current_exception();
+                        }
+                    }
+                    outstanding_.fetch_sub(1, std::memory_order_acq_rel);
+                });
+        }
+
+        // Block until every task has finished; rethrows the first exception
+        void wait()
+        {
+            wait_for_completion();
+            if (error_)
+            {
+                std::rethrow_exception(std::exchange(error_, nullptr));
+            }
+        }
+
+    private:
+        void wait_for_completion() noexcept
+        {
+            while (outstanding_.load(std::memory_order_acquire) != 0)
+            {
+                if (!pool_.run_pending_task())
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        work_stealing_pool&      pool_;
+        std::atomic<std::size_t> outstanding_{0};
+        std::mutex               error_mutex_;
+        std::exception_ptr       error_;
+    };
+
+    // Call fn(begin, end) for consecutive chunks of [0, count)
+    template <typename Fn>
+    void parallel_for(work_stealing_pool& pool, std::size_t count,
+                      std::size_t grain, Fn&& fn)
+    {
+        grain = std::max<std::size_t>(grain, 1);
+        if (count <= grain)
+        {
+            if (count != 0)
+            {
+                fn(std::size_t{0}, count);
+            }
+            return;
+        }
+        task_group group(pool);
+        for (std::size_t begin = grain; begin < count; begin += grain)
+        {
+            const std::size_t end = std::min(begin + grain, count);
+            group.run([&fn, begin, end] { fn(begin, end); });
+        }
+        fn(std::size_t{0}, grain); // The caller takes the first chunk
+        group.wait();
+    }
+
+    // =============================================================================
+    // Access Declarations
+    // =============================================================================
+
+    // Identity of a component type; unique per type across translation units
+    template <typename T>
+    const void* resource_key() noexcept
+    {
+        static const char key = 0;
+        return &key;
+    }
+
+    // The component types and container instances a system touches. Types
+    // and instances are separate keys: declare whichever the system uses.
+    class system_access
+    {
+    public:
+        template <typename... Ts>
+        system_access& reads()
+        {
+            (reads_.push_back(resource_key<std::remove_cvref_t<Ts>>()), ...);
+            return *this;
+        }
+
+        template <typename... Ts>
+        system_access& writes()
+        {
+            (writes_.push_back(resource_key<std::remove_cvref_t<Ts>>()), ...);
+            return *this;
+        }
+
+        template <typename Container>
+        system_access& read(const Container& container)
+        {
+            reads_.push_back(&container);
+            return *this;
+        }
+
+        template <typename Container>
+        system_access& write(const Container& container)
+        {
+            writes_.push_back(&container);
+            return *this;
+        }
+
+        // Two systems conflict if either writes something the other touches
+        [[nodiscard]] bool conflicts_with(const system_access& other) const
+        {
+            return overlaps(writes_, other.writes_) ||
+                   overlaps(writes_, other.reads_) ||
+                   overlaps(reads_, other.writes_);
+        }
+
+    private:
+        static bool overlaps(const std::vector<const void*>& a,
+                             const std::vector<const void*>& b)
+        {
+            return std::ranges::any_of(
+                a, [&](const void* key)
+                { return std::ranges::find(b, key) != b.end(); });
+        }
+
+        std::vector<const void*> reads_;
+        std::vector<const void*> writes_;
+    };
+
+    inline system_access access()
+    {
+        return {};
+    }
+
+    // =============================================================================
+    // System Scheduler
+    // =============================================================================
+
+    // Handed to every system; gives access to chunk parallelism on the pool
+    class system_context
+    {
+    public:
+        explicit system_context(work_stealing_pool& pool) noexcept : pool_(pool)
+        {}
+
+        [[nodiscard]] work_stealing_pool& pool() const noexcept
+        {
+            return pool_;
+        }
+
+        template <typename Fn>
+        void parallel_for(std::size_t count, std::size_t grain, Fn&& fn) const
+        {
+            inline_poly::parallel_for(pool_, count, grain, std::forward<Fn>(fn));
+        }
+
+        // Call fn(element) for every element of an indexable container
+        // (array slots may be empty and are skipped)
+        template <typename Container, typename Fn>
+        void for_each(Container& container, std::size_t grain, Fn&& fn) const
+        {
+            inline_poly::parallel_for(
+                pool_, container.size(), grain,
+                [&](std::size_t begin, std::size_t end)
+                {
+                    for (std::size_t i = begin; i < end; ++i)
+                    {
+                        if (auto* element = container[i])
+                        {
+                            fn(*element);
+                        }
+                    }
+                });
+        }
+
+    private:
+        work_stealing_pool& pool_;
+    };
+
+    class system_scheduler
+    {
+    public:
+        using system_id = std::size_t;
+
+        explicit system_scheduler(work_stealing_pool& pool) noexcept : pool_(pool)
+        {}
+
+        // fn is invoked as fn(system_context&) or fn()
+        template <typename Fn>
+        system_id add_system(const char* name, system_access access, Fn&& fn)
+        {
+            system entry;
+            entry.name   = name;
+            entry.access = std::move(access);
+            if constexpr (std::is_invocable_v<Fn&, system_context&>)
+            {
+                entry.run = std::forward<Fn>(fn);
+            }
+            else
+            {
+                entry.run = [fn = std::forward<Fn>(fn)](system_context&) mutable
+                { fn(); };
+            }
+            systems_.push_back(std::move(entry));
+            return systems_.size() - 1;
+        }
+
+        void set_enabled(system_id id, bool enabled)
+        {
+            checked(id, "set_enabled").enabled = enabled;
+        }
+
+        // Build the dependency graph of the enabled systems and run them,
+        // independent systems in parallel. Rethrows the first exception after
+        // all started systems finished; systems depending on a failed one are
+        // skipped.
+        void run_frame()
+        {
+            build_graph();
+
+            std::vector<std::atomic<std::size_t>> remaining(systems_.size());
+            for (system_id id = 0; id < systems_.size(); ++id)
+            {
+                remaining[id].store(systems_[id].dependencies.size(),
+                                    std::memory_order_relaxed);
+            }
+
+            std::atomic<bool>  failed{false};
+            std::mutex         error_mutex;
+            std::exception_ptr error;
+            task_group         group(pool_);
+            system_context     context(pool_);
+
+            std::function<void(system_id)> launch = [&](system_id id)
+            {
+                group.run(
+                    [&, id]
+                    {
+                        if (!failed.load(std::memory_order_acquire))
+                        {
+                            try
+                            {
+                                systems_[id].run(context);
+                            }
+                            catch (...)
+                            {
+                                std::lock_guard lock(error_mutex);
+                                if (!error)
+                                {
+                                    error = std::current_exception();
+                                }
+                                failed.store(true, std::memory_order_release);
+                            }
+                        }
+                        for (system_id next : systems_[id].dependents)
+                        {
+                            if (remaining[next].fetch_sub(
+                                    1, std::memory_order_acq_rel) == 1)
+                            {
+                                launch(next);
+                            }
+                        }
+                    });
+            };
+
+            for (system_id id = 0; id < systems_.size(); ++id)
+            {
+                if (systems_[id].enabled && systems_[id].dependencies.empty())
+                {
+                    launch(id);
+                }
+            }
+            group.wait();
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+
+        // Systems that `id` waited for in the last frame
+        [[nodiscard]] const std::vector<system_id>&
+        dependencies(system_id id) const
+        {
+            return checked(id, "dependencies").dependencies;
+        }
+
+        [[nodiscard]] const char* name(system_id id) const
+        {
+            return checked(id, "name").name;
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept
+        {
+            return systems_.size();
+        }
+
+    private:
+        struct system
+        {
+            const char*                          name = nullptr;
+            system_access                        access;
+            std::function<void(system_context&)> run;
+            bool                                 enabled = true;
+            std::vector<system_id>               dependencies;
+            std::vector<system_id>               dependents;
+        };
+
+        template <typename Self>
+        static auto& checked_impl(Self& self, system_id id, const char* operation)
+        {
+            if (id >= self.systems_.size())
+            {
+                throw std::out_of_range(std::string("system_scheduler::") +
+                                        operation + "() - invalid system id");
+            }
+            return self.systems_[id];
+        }
+
+        system& checked(system_id id, const char* operation)
+        {
+            return checked_impl(*this, id, operation);
+        }
+
+        const system& checked(system_id id, const char* operation) const
+        {
+            return checked_impl(*this, id, operation);
+        }
+
+        // A system depends on every earlier enabled system it conflicts with,
+        // so conflicting systems run in registration order
+        void build_graph()
+        {
+            for (system& s : systems_)
+            {
+                s.dependencies.clear();
+                s.dependents.clear();
+            }
+            for (system_id later = 0; later < systems_.size(); ++later)
+            {
+                if (!systems_[later].enabled)
+                {
+                    continue;
+                }
+                for (system_id earlier = 0; earlier < later; ++earlier)
+                {
+                    if (systems_[earlier].enabled &&
+                        systems_[earlier].access.conflicts_with(
+                            systems_[later].access))
+                    {
+                        systems_[later].dependencies.push_back(earlier);
+                        systems_[earlier].dependents.push_back(later);
+                    }
+                }
+            }
+        }
+
+        work_stealing_pool& pool_;
+        std::vector<system> systems_;
+    };
+
+} // namespace inline_poly
+
+#endif // INLINE_POLY_SCHEDULER_H
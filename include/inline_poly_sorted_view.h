@@ -0,0 +1,302 @@
+// Copyright 2025 Dr. Matthias Hölzl
+
+// inline_poly_sorted_view.h - Key-ordered view without relocating objects
+//
+// sorted_view visits the elements of a poly_array or poly_vector in the order
+// of a key such as depth or priority, while the objects stay where they are.
+// It keeps a permutation of compact slot indices and a cached key per slot;
+// refresh() brings both up to date after the container or the keys changed.
+//
+// Since the previous order is kept, refresh() repairs it with an insertion
+// pass, which costs O(N) when only a few elements moved. If the pass has to
+// shift too many entries it falls back to a full sort, so a shuffled order
+// costs O(N log N). Like the containers, the view never allocates.
+//
+//     inline_poly::sorted_view by_depth(sprites, [](const Sprite& s)
+//                                       { return s.depth(); });
+//     for (Sprite* sprite : by_depth) { sprite->draw(); }
+//     // Next frame:
+//     by_depth.refresh();
+
+#pragma once
+#ifndef INLINE_POLY_SORTED_VIEW_H
+#define INLINE_POLY_SORTED_VIEW_H
+
+#include "inline_poly.h"
+
+#include <algorithm>
+#include <array>
+#include <compare>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace inline_poly
+{
+
+    namespace detail
+    {
+        // Number of slots of an inline container, known at compile time
+        template <typename Container>
+        struct static_capacity;
+
+        template <typename Base, size_t N, size_t SlotSize, size_t Alignment,
+                  typename Policy>
+        struct static_capacity<poly_array<Base, N, SlotSize, Alignment, Policy>>
+        {
+            static constexpr size_t value = N;
+        };
+
+        template <typename Base, size_t Capacity, size_t SlotSize,
+                  size_t Alignment, typename Policy>
+        struct static_capacity<
+            poly_vector<Base, Capacity, SlotSize, Alignment, Policy>>
+        {
+            static constexpr size_t value = Capacity;
+        };
+    } // namespace detail
+
+    template <typename Container, typename KeyFn, typename Compare = std::less<>>
+    class sorted_view
+    {
+        static constexpr size_t capacity =
+            detail::static_capacity<std::remove_const_t<Container>>::value;
+        static_assert(capacity <= std::numeric_limits<std::uint32_t>::max(),
+                      "sorted_view stores 32-bit slot indices");
+
+        static constexpr size_t bitmap_words = (capacity + 63) / 64;
+
+    public:
+        using size_type    = size_t;
+        using element_type = std::remove_cvref_t<
+            decltype(std::declval<Container&>()[size_type{}])>;
+        using key_type = std::remove_cvref_t<std::invoke_result_t<
+            KeyFn&, decltype(*std::declval<element_type>())>>;
+
+        // Random-access iterator yielding the elements in key order
+        class iterator
+        {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type        = element_type;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = void;
+            using reference         = element_type;
+
+            iterator() = default;
+            iterator(Container* container, const std::uint32_t* pos) noexcept :
+                container_(container), pos_(pos)
+            {}
+
+            reference operator*() const
+            {
+                return (*container_)[*pos_];
+            }
+            reference operator[](difference_type n) const
+            {
+                return (*container_)[pos_[n]];
+            }
+
+            iterator& operator++() noexcept
+            {
+                ++pos_;
+                return *this;
+            }
+            iterator operator++(int) noexcept
+            {
+                iterator tmp = *this;
+                ++pos_;
+                return tmp;
+            }
+            iterator& operator--() noexcept
+            {
+                --pos_;
+                return *this;
+            }
+            iterator operator--(int) noexcept
+            {
+                iterator tmp = *this;
+                --pos_;
+                return tmp;
+            }
+            iterator& operator+=(difference_type n) noexcept
+            {
+                pos_ += n;
+                return *this;
+            }
+            iterator& operator-=(difference_type n) noexcept
+            {
+                pos_ -= n;
+                return *this;
+            }
+            friend iterator operator+(iterator it, difference_type n) noexcept
+            {
+                return it += n;
+            }
+            friend iterator operator+(difference_type n, iterator it) noexcept
+            {
+                return it += n;
+            }
+            friend iterator operator-(iterator it, difference_type n) noexcept
+            {
+                return it -= n;
+            }
+            friend difference_type operator-(const iterator& lhs,
+                                             const iterator& rhs) noexcept
+            {
+                return lhs.pos_ - rhs.pos_;
+            }
+
+            bool operator==(const iterator& other) const noexcept
+            {
+                return pos_ == other.pos_;
+            }
+            auto operator<=>(const iterator& other) const noexcept
+            {
+                return pos_ <=> other.pos_;
+            }
+
+            // Slot index of the element in the container
+            [[nodiscard]] size_type index() const noexcept
+            {
+                return *pos_;
+            }
+
+        private:
+            Container*           container_ = nullptr;
+            const std::uint32_t* pos_       = nullptr;
+        };
+
+        sorted_view(Container& container, KeyFn key, Compare compare = {}) :
+            container_(&container), key_(std::move(key)),
+            compare_(std::move(compare))
+        {
+            refresh();
+        }
+
+        // Bring the order up to date: drop slots that became empty, append
+        // new ones, re-read every key and repair the previous order. Returns
+        // true if the repair fell back to a full sort.
+        bool refresh()
+        {
+            Container&      container = *container_;
+            const size_type slots     = container.size();
+
+            // Keep the previous order of the slots that are still occupied
+            std::array<std::uint64_t, bitmap_words> seen{};
+            size_type                               count = 0;
+            for (size_type k = 0; k < size_; ++k)
+            {
+                const std::uint32_t index = perm_[k];
+                if (index < slots && container[index] &&
+                    !((seen[index / 64] >> (index % 64)) & 1u))
+                {
+                    seen[index / 64] |= std::uint64_t{1} << (index % 64);
+                    perm_[count++] = index;
+                }
+            }
+            for (size_type index = 0; index < slots; ++index)
+            {
+                if (container[index] &&
+                    !((seen[index / 64] >> (index % 64)) & 1u))
+                {
+                    perm_[count++] = static_cast<std::uint32_t>(index);
+                }
+            }
+            size_ = count;
+
+            for (size_type k = 0; k < size_; ++k)
+            {
+                keys_[perm_[k]] = std::invoke(key_, *container[perm_[k]]);
+            }
+            return repair_order();
+        }
+
+        iterator begin() const noexcept
+        {
+            return iterator(container_, perm_.data());
+        }
+        iterator end() const noexcept
+        {
+            return iterator(container_, perm_.data() + size_);
+        }
+
+        [[nodiscard]] element_type operator[](size_type k) const
+        {
+            return (*container_)[perm_[k]];
+        }
+
+        // Slot indices in key order
+        [[nodiscard]] std::span<const std::uint32_t> indices() const noexcept
+        {
+            return {perm_.data(), size_};
+        }
+
+        // Key cached for the element in slot index by the last refresh()
+        [[nodiscard]] const key_type& key_at(size_type index) const noexcept
+        {
+            return keys_[index];
+        }
+
+        [[nodiscard]] size_type size() const noexcept
+        {
+            return size_;
+        }
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return size_ == 0;
+        }
+
+    private:
+        // Ties are broken by slot index, so the order is deterministic
+        bool before(std::uint32_t lhs, std::uint32_t rhs) const
+        {
+            if (compare_(keys_[lhs], keys_[rhs]))
+            {
+                return true;
+            }
+            return !compare_(keys_[rhs], keys_[lhs]) && lhs < rhs;
+        }
+
+        // Insertion pass over the previous order; once it has shifted more
+        // than a few entries per element the order is too far off and the
+        // rest is left to std::sort
+        bool repair_order()
+        {
+            size_type budget = 4 * size_ + 64;
+            for (size_type i = 1; i < size_; ++i)
+            {
+                const std::uint32_t value = perm_[i];
+                size_type           j     = i;
+                for (; j > 0 && before(value, perm_[j - 1]); --j)
+                {
+                    if (budget-- == 0)
+                    {
+                        perm_[j] = value;
+                        std::sort(perm_.begin(), perm_.begin() + size_,
+                                  [this](std::uint32_t lhs, std::uint32_t rhs)
+                                  { return before(lhs, rhs); });
+                        return true;
+                    }
+                    perm_[j] = perm_[j - 1];
+                }
+                perm_[j] = value;
+            }
+            return false;
+        }
+
+        Container*                          container_;
+        KeyFn                               key_;
+        Compare                             compare_;
+        std::array<std::uint32_t, capacity> perm_{};
+        std::array<key_type, capacity>      keys_{};
+        size_type                           size_ = 0;
+    };
+
+} // namespace inline_poly
+
+#endif // INLINE_POLY_SORTED_VIEW_H
@@ -0,0 +1,391 @@
+// Copyright 2025 Dr. Matthias Hölzl
+
+// inline_poly_state_machine.h - Finite state machine with inline state storage
+//
+// poly_state_machine keeps the current state object in an inline slot of the
+// machine, so a per-entity machine sits in the entity's own cache lines and a
+// transition never allocates: transition<NewState>(args...) constructs the
+// new state and destroys the old one through its type_operations. A second
+// slot holds either a deferred transition (requested from inside the running
+// state, applied later by apply_pending()) or the previous state during a
+// cross-fade, while both states are alive.
+//
+// If StateBase declares on_enter() or on_exit(), transitions call them when a
+// state becomes current or stops being current. reset() and destruction do
+// not call hooks.
+
+#pragma once
+#ifndef INLINE_POLY_STATE_MACHINE_H
+#define INLINE_POLY_STATE_MACHINE_H
+
+#include "inline_poly.h"
+
+#include <array>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+namespace inline_poly
+{
+
+    template <typename State>
+    concept HasOnEnter = requires(State& state) { state.on_enter(); };
+
+    template <typename State>
+    concept HasOnExit = requires(State& state) { state.on_exit(); };
+
+    template <PolymorphicBase StateBase, size_t SlotSize,
+              size_t Alignment = alignof(std::max_align_t)>
+    class poly_state_machine
+    {
+    public:
+        static_assert(SlotSize >= sizeof(StateBase),
+                      "SlotSize must hold StateBase");
+        static_assert(Alignment >= alignof(StateBase),
+                      "Alignment must be at least alignof(StateBase)");
+        static_assert(SlotSize % Alignment == 0,
+                      "SlotSize must be a multiple of Alignment");
+
+        // What the second slot currently holds
+        enum class secondary_role : std::uint8_t
+        {
+            none,
+            pending, // Deferred transition target
+            fading,  // Previous state during a cross-fade
+        };
+
+    private:
+        struct slot_info
+        {
+            StateBase*             ptr = nullptr;
+            const type_operations* ops = nullptr;
+        };
+
+        alignas(Alignment) std::byte storage_[2 * SlotSize]{};
+        std::array<slot_info, 2> slots_{};
+        std::uint8_t             current_ = 0; // Index of the current slot
+        secondary_role           role_    = secondary_role::none;
+
+    public:
+        poly_state_machine() = default;
+
+        // Copies both slots; throws std::logic_error if a state is not
+        // copy constructible
+        poly_state_machine(const poly_state_machine& other)
+        {
+            copy_from(other);
+        }
+
+        poly_state_machine(poly_state_machine&& other) noexcept
+        {
+            move_from(std::move(other));
+        }
+
+        poly_state_machine& operator=(const poly_state_machine& other)
+        {
+            if (this != &other)
+            {
+                if (!other.is_copyable())
+                {
+                    throw std::logic_error("Cannot copy poly_state_machine: "
+                                           "contains non-copyable states");
+                }
+                reset();
+                copy_from(other);
+            }
+            return *this;
+        }
+
+        poly_state_machine& operator=(poly_state_machine&& other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                move_from(std::move(other));
+            }
+            return *this;
+        }
+
+        ~poly_state_machine()
+        {
+            reset();
+        }
+
+        // --- Transitions ---
+
+        // Replace the current state immediately. Must not be called from a
+        // member function of the current state (that object is destroyed);
+        // use defer() there. Discards a pending or fading state.
+        template <typename NewState, typename... Args>
+            requires FitsInSlot<NewState, StateBase, SlotSize, Alignment> &&
+                     std::constructible_from<NewState, Args...>
+        NewState& transition(Args&&... args)
+        {
+            // Construct first: args may refer to the old state, and a
+            // throwing constructor leaves the current state in place. The
+            // secondary slot is reused, so a pending or fading state is
+            // discarded even when the constructor throws.
+            NewState& state =
+                construct_secondary<NewState>(std::forward<Args>(args)...);
+            leave_current();
+            destroy_slot(current_);
+            current_ = secondary();
+            enter_current();
+            return state;
+        }
+
+        // Construct the next state now but switch to it on apply_pending()
+        template <typename NewState, typename... Args>
+            requires FitsInSlot<NewState, StateBase, SlotSize, Alignment> &&
+                     std::constructible_from<NewState, Args...>
+        NewState& defer(Args&&... args)
+        {
+            NewState& state =
+                construct_secondary<NewState>(std::forward<Args>(args)...);
+            role_ = secondary_role::pending;
+            return state;
+        }
+
+        // Switch to the deferred state, if any
+        bool apply_pending()
+        {
+            if (role_ != secondary_role::pending)
+            {
+                return false;
+            }
+            leave_current();
+            destroy_slot(current_);
+            current_ = secondary();
+            role_    = secondary_role::none;
+            enter_current();
+            return true;
+        }
+
+        // Make a new state current while keeping the old one alive as
+        // previous() until finish_crossfade()
+        template <typename NewState, typename... Args>
+            requires FitsInSlot<NewState, StateBase, SlotSize, Alignment> &&
+                     std::constructible_from<NewState, Args...>
+        NewState& crossfade(Args&&... args)
+        {
+            NewState& state =
+                construct_secondary<NewState>(std::forward<Args>(args)...);
+            leave_current();
+            current_ = secondary();
+            role_    = slots_[secondary()].ptr ? secondary_role::fading
+                                               : secondary_role::none;
+            enter_current();
+            return state;
+        }
+
+        // Destroy the state that was faded out
+        void finish_crossfade() noexcept
+        {
+            if (role_ == secondary_role::fading)
+            {
+                destroy_slot(secondary());
+                role_ = secondary_role::none;
+            }
+        }
+
+        // Destroy every state without calling hooks
+        void reset() noexcept
+        {
+            destroy_slot(0);
+            destroy_slot(1);
+            current_ = 0;
+            role_    = secondary_role::none;
+        }
+
+        // --- Access ---
+
+        [[nodiscard]] StateBase* current() noexcept
+        {
+            return slots_[current_].ptr;
+        }
+        [[nodiscard]] const StateBase* current() const noexcept
+        {
+            return slots_[current_].ptr;
+        }
+
+        // The deferred state, nullptr if none is pending
+        [[nodiscard]] StateBase* pending() noexcept
+        {
+            return role_ == secondary_role::pending ? slots_[secondary()].ptr
+                                                    : nullptr;
+        }
+
+        // The state being faded out, nullptr outside a cross-fade
+        [[nodiscard]] StateBase* previous() noexcept
+        {
+            return role_ == secondary_role::fading ? slots_[secondary()].ptr
+                                                   : nullptr;
+        }
+
+        [[nodiscard]] secondary_role secondary_state() const noexcept
+        {
+            return role_;
+        }
+
+        [[nodiscard]] bool has_state() const noexcept
+        {
+            return slots_[current_].ptr != nullptr;
+        }
+
+        // Exact-type check by type_operations identity
+        template <typename State>
+        [[nodiscard]] bool is_in() const noexcept
+        {
+            return slots_[current_].ops == &get_type_ops<State>();
+        }
+
+        template <typename State>
+        [[nodiscard]] State* get_if() noexcept
+        {
+            return is_in<State>()
+                       ? static_cast<State*>(slots_[current_].ptr)
+                       : nullptr;
+        }
+
+        [[nodiscard]] bool is_copyable() const noexcept
+        {
+            for (const slot_info& slot : slots_)
+            {
+                if (slot.ptr && !slot.ops->is_copy_constructible)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        [[nodiscard]] static constexpr size_t slot_size() noexcept
+        {
+            return SlotSize;
+        }
+
+    private:
+        [[nodiscard]] std::uint8_t secondary() const noexcept
+        {
+            return static_cast<std::uint8_t>(1 - current_);
+        }
+
+        void* slot_storage(std::size_t index) noexcept
+        {
+            return storage_ + index * SlotSize;
+        }
+
+        template <typename NewState, typename... Args>
+        NewState& construct_secondary(Args&&... args)
+        {
+            const std::uint8_t index = secondary();
+            if (slots_[index].ptr)
+            {
+                destroy_slot(index);
+                role_ = secondary_role::none;
+            }
+            auto* state = new (slot_storage(index))
+                NewState(std::forward<Args>(args)...);
+            slots_[index] = {.ptr = state, .ops = &get_type_ops<NewState>()};
+            return *state;
+        }
+
+        void destroy_slot(std::size_t index) noexcept
+        {
+            if (slots_[index].ptr)
+            {
+                safe_destroy(slot_storage(index), *slots_[index].ops);
+                slots_[index] = {};
+            }
+        }
+
+        void enter_current()
+        {
+            if constexpr (HasOnEnter<StateBase>)
+            {
+                slots_[current_].ptr->on_enter();
+            }
+        }
+
+        void leave_current()
+        {
+            if constexpr (HasOnExit<StateBase>)
+            {
+                if (slots_[current_].ptr)
+                {
+                    slots_[current_].ptr->on_exit();
+                }
+            }
+        }
+
+        // Re-derive a slot's StateBase pointer at the same storage offset as
+        // in the source machine
+        StateBase* rebase(const poly_state_machine& other,
+                          std::size_t index) noexcept
+        {
+            const auto offset =
+                reinterpret_cast<const std::byte*>(other.slots_[index].ptr) -
+                other.storage_;
+            return std::launder(
+                reinterpret_cast<StateBase*>(storage_ + offset));
+        }
+
+        void copy_from(const poly_state_machine& other)
+        {
+            if (!other.is_copyable())
+            {
+                throw std::logic_error("Cannot copy poly_state_machine: "
+                                       "contains non-copyable states");
+            }
+            try
+            {
+                for (std::size_t i = 0; i < 2; ++i)
+                {
+                    if (other.slots_[i].ptr)
+                    {
+                        safe_copy_construct(slot_storage(i),
+                                            other.storage_ + i * SlotSize,
+                                            *other.slots_[i].ops);
+                        slots_[i] = {.ptr = rebase(other, i),
+                                     .ops = other.slots_[i].ops};
+                    }
+                }
+            }
+            catch (...)
+            {
+                reset();
+                throw;
+            }
+            current_ = other.current_;
+            role_    = other.role_;
+        }
+
+        void move_from(poly_state_machine&& other) noexcept
+        {
+            for (std::size_t i = 0; i < 2; ++i)
+            {
+                if (other.slots_[i].ptr)
+                {
+                    safe_move_construct(slot_storage(i), other.slot_storage(i),
+                                        *other.slots_[i].ops);
+                    slots_[i] = {.ptr = rebase(other, i),
+                                 .ops = other.slots_[i].ops};
+                    other.destroy_slot(i);
+                }
+            }
+            current_       = other.current_;
+            role_          = other.role_;
+            other.current_ = 0;
+            other.role_    = secondary_role::none;
+        }
+    };
+
+    // Convenience alias
+    template <PolymorphicBase StateBase, size_t SlotSize,
+              size_t Alignment = alignof(std::max_align_t)>
+    using state_machine = poly_state_machine<StateBase, SlotSize, Alignment>;
+
+} // namespace inline_poly
+
+#endif // INLINE_POLY_STATE_MACHINE_H
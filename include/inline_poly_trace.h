@@ -0,0 +1,300 @@
+// Copyright 2025 Dr. Matthias Hölzl
+
+// inline_poly_trace.h - Chrome trace span recording for inline_poly containers
+//
+// Containers instantiated with a policy whose `trace` member is
+// `chrome_trace` record a timed span for every expensive operation (erase
+// with shifts, whole-container copy and move, clear, capability rescans and
+// iterator cache rebuilds). Spans go into a lock-free ring buffer owned by the
+// recording thread and can be flushed as Chrome trace JSON, which loads in
+// chrome://tracing and Perfetto.
+
+#pragma once
+#ifndef INLINE_POLY_TRACE_H
+#define INLINE_POLY_TRACE_H
+
+#include "inline_poly.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace inline_poly
+{
+
+    // =============================================================================
+    // Trace Events
+    // =============================================================================
+
+    // A completed span. `name` must point to storage with static duration
+    // (string literals), since it is only dereferenced when flushing.
+    struct trace_event
+    {
+        const char*   name     = nullptr;
+        std::uint64_t begin_ns = 0;
+        std::uint64_t end_ns   = 0;
+        std::size_t   count    = 0; // Elements touched by the operation
+    };
+
+    // Single-producer/single-consumer ring buffer of trace events. The owning
+    // thread pushes, the flushing thread drains; neither side takes a lock.
+    // Events pushed while the ring is full are dropped and counted.
+    template <std::size_t Capacity>
+    class trace_ring
+    {
+        static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                      "trace_ring capacity must be a power of two");
+
+    public:
+        bool try_push(const trace_event& event) noexcept
+        {
+            const std::uint64_t head = head_.load(std::memory_order_relaxed);
+            if (head - tail_.load(std::memory_order_acquire) >= Capacity)
+            {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            events_[head & (Capacity - 1)] = event;
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Hand every buffered event to `fn` and release its storage
+        template <typename Fn>
+        std::size_t drain(Fn&& fn)
+        {
+            const std::uint64_t head = head_.load(std::memory_order_acquire);
+            std::uint64_t       tail = tail_.load(std::memory_order_relaxed);
+            const std::size_t   n    = static_cast<std::size_t>(head - tail);
+            for (; tail != head; ++tail)
+            {
+                fn(events_[tail & (Capacity - 1)]);
+            }
+            tail_.store(tail, std::memory_order_release);
+            return n;
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept
+        {
+            return static_cast<std::size_t>(
+                head_.load(std::memory_order_acquire) -
+                tail_.load(std::memory_order_acquire));
+        }
+
+        [[nodiscard]] std::uint64_t dropped() const noexcept
+        {
+            return dropped_.load(std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] static constexpr std::size_t capacity() noexcept
+        {
+            return Capacity;
+        }
+
+    private:
+        std::array<trace_event, Capacity> events_{};
+        alignas(64) std::atomic<std::uint64_t> head_{0};
+        alignas(64) std::atomic<std::uint64_t> tail_{0};
+        std::atomic<std::uint64_t> dropped_{0};
+    };
+
+    // =============================================================================
+    // Trace Recorder - Process-wide registry of per-thread rings
+    // =============================================================================
+
+    class trace_recorder
+    {
+    public:
+        static constexpr std::size_t ring_capacity = 4096;
+
+        static trace_recorder& instance()
+        {
+            static trace_recorder recorder;
+            return recorder;
+        }
+
+        trace_recorder(const trace_recorder&)            = delete;
+        trace_recorder& operator=(const trace_recorder&) = delete;
+
+        // Nanoseconds since the recorder was created
+        [[nodiscard]] std::uint64_t now() const noexcept
+        {
+            return static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - epoch_)
+                    .count());
+        }
+
+        // Push an event into the calling thread's ring. The first event of a
+        // thread registers its ring (one allocation); later events are
+        // lock-free. Events are dropped if the ring is full or registration
+        // fails.
+        void record(const trace_event& event) noexcept
+        {
+            if (thread_buffer* buffer = local_buffer())
+            {
+                buffer->ring.try_push(event);
+            }
+        }
+
+        // Drain all rings and write the events as Chrome trace JSON
+        void write_chrome_json(std::ostream& out)
+        {
+            std::lock_guard lock(registry_mutex_);
+
+            out << "{\"traceEvents\":[";
+            bool first = true;
+            for (const auto& buffer : buffers_)
+            {
+                buffer->ring.drain(
+                    [&](const trace_event& event)
+                    {
+                        out << (first ? "\n" : ",\n");
+                        first = false;
+                        write_event(out, event, buffer->tid);
+                    });
+            }
+            out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+        }
+
+        // Discard all buffered events without writing them
+        void discard()
+        {
+            std::lock_guard lock(registry_mutex_);
+            for (const auto& buffer : buffers_)
+            {
+                buffer->ring.drain([](const trace_event&) {});
+            }
+        }
+
+        [[nodiscard]] std::size_t pending() const
+        {
+            std::lock_guard lock(registry_mutex_);
+            std::size_t     total = 0;
+            for (const auto& buffer : buffers_)
+            {
+                total += buffer->ring.size();
+            }
+            return total;
+        }
+
+        [[nodiscard]] std::uint64_t dropped() const
+        {
+            std::lock_guard lock(registry_mutex_);
+            std::uint64_t   total = 0;
+            for (const auto& buffer : buffers_)
+            {
+                total += buffer->ring.dropped();
+            }
+            return total;
+        }
+
+    private:
+        struct thread_buffer
+        {
+            std::uint32_t             tid = 0;
+            trace_ring<ring_capacity> ring;
+        };
+
+        trace_recorder() : epoch_(std::chrono::steady_clock::now()) {}
+
+        // Buffers are owned by the registry rather than by the thread, so
+        // events survive thread exit until they are flushed.
+        thread_buffer* local_buffer() noexcept
+        {
+            thread_local thread_buffer* buffer = nullptr;
+            if (buffer == nullptr)
+            {
+                try
+                {
+                    auto owned = std::make_unique<thread_buffer>();
+                    std::lock_guard lock(registry_mutex_);
+                    owned->tid = static_cast<std::uint32_t>(buffers_.size() + 1);
+                    buffers_.push_back(std::move(owned));
+                    buffer = buffers_.back().get();
+                }
+                catch (...)
+                {
+                    return nullptr;
+                }
+            }
+            return buffer;
+        }
+
+        static void write_event(std::ostream& out, const trace_event& event,
+                                std::uint32_t tid)
+        {
+            out << "{\"name\":\"";
+            for (const char* c = event.name; c && *c; ++c)
+            {
+                if (*c == '"' || *c == '\\')
+                {
+                    out << '\\';
+                }
+                out << *c;
+            }
+            out << "\",\"cat\":\"inline_poly\",\"ph\":\"X\",\"pid\":1"
+                << ",\"tid\":" << tid << ",\"ts\":";
+            write_micros(out, event.begin_ns);
+            out << ",\"dur\":";
+            write_micros(out, event.end_ns - event.begin_ns);
+            out << ",\"args\":{\"count\":" << event.count << "}}";
+        }
+
+        // Chrome trace timestamps are microseconds; keep nanosecond precision
+        static void write_micros(std::ostream& out, std::uint64_t ns)
+        {
+            const std::uint64_t frac = ns % 1000;
+            out << ns / 1000 << '.' << static_cast<char>('0' + frac / 100)
+                << static_cast<char>('0' + frac / 10 % 10)
+                << static_cast<char>('0' + frac % 10);
+        }
+
+        std::chrono::steady_clock::time_point       epoch_;
+        mutable std::mutex                          registry_mutex_;
+        std::vector<std::unique_ptr<thread_buffer>> buffers_;
+    };
+
+    // =============================================================================
+    // Chrome Trace Policy
+    // =============================================================================
+
+    // Trace policy that records a span for each instrumented operation into
+    // the trace_recorder. Also usable directly to mark user spans, e.g. frames.
+    struct chrome_trace
+    {
+        class scope
+        {
+        public:
+            explicit scope(const char* name, std::size_t count = 0) noexcept :
+                name_(name), count_(count),
+                begin_ns_(trace_recorder::instance().now())
+            {}
+
+            scope(const scope&)            = delete;
+            scope& operator=(const scope&) = delete;
+
+            ~scope()
+            {
+                trace_recorder& recorder = trace_recorder::instance();
+                recorder.record({.name     = name_,
+                                 .begin_ns = begin_ns_,
+                                 .end_ns   = recorder.now(),
+                                 .count    = count_});
+            }
+
+        private:
+            const char*   name_;
+            std::size_t   count_;
+            std::uint64_t begin_ns_;
+        };
+    };
+
+} // namespace inline_poly
+
+#endif // INLINE_POLY_TRACE_H
@@ -0,0 +1,579 @@
+// Copyright 2025 Dr. Matthias Hölzl
+
+// inline_poly_tree.h - Flattened polymorphic tree with depth-first layout
+//
+// poly_tree stores the nodes of a forest (scene graph, behavior tree, UI
+// hierarchy) in inline slots in pre-order, so a depth-first traversal is a
+// linear scan over contiguous memory. Every node records its parent, its depth
+// and the size of its subtree; the subtree of node i occupies the index range
+// [i, subtree_end(i)), which makes skipping a subtree O(1).
+//
+// Node indices are positions in pre-order. Inserting, erasing or moving a
+// subtree relocates the nodes behind it and therefore changes their indices.
+// Nodes must be move constructible, since structural edits relocate them
+// through their type_operations.
+
+#pragma once
+#ifndef INLINE_POLY_TREE_H
+#define INLINE_POLY_TREE_H
+
+#include "inline_poly.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <new>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+namespace inline_poly
+{
+
+    template <PolymorphicBase NodeBase, size_t N, size_t SlotSize,
+              size_t Alignment = alignof(std::max_align_t)>
+    class poly_tree
+    {
+    public:
+        static_assert(SlotSize >= sizeof(NodeBase),
+                      "SlotSize must hold NodeBase");
+        static_assert(Alignment >= alignof(NodeBase),
+                      "Alignment must be at least alignof(NodeBase)");
+        static_assert(SlotSize % Alignment == 0,
+                      "SlotSize must be a multiple of Alignment");
+
+        // Typedefs for STL compatibility; iteration visits nodes in pre-order
+        using value_type             = NodeBase*;
+        using size_type              = size_t;
+        using difference_type        = std::ptrdiff_t;
+        using iterator               = NodeBase**;
+        using const_iterator         = NodeBase* const*;
+        using reverse_iterator       = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        // Parent index of root nodes and result of failed lookups
+        static constexpr size_type npos = static_cast<size_type>(-1);
+
+    private:
+        struct node_info
+        {
+            const type_operations* ops         = nullptr;
+            size_type              parent      = npos;
+            size_type              subtree     = 0; // Node count incl. self
+            size_type              depth       = 0;
+            size_type              base_offset = 0; // NodeBase within slot
+        };
+
+        alignas(Alignment) std::byte storage_[N * SlotSize]{};
+        std::array<NodeBase*, N> ptrs_{};
+        std::array<node_info, N> info_{};
+        size_type                size_         = 0;
+        size_type                non_copyable_ = 0;
+
+    public:
+        poly_tree() noexcept = default;
+
+        poly_tree(const poly_tree& other)
+        {
+            copy_from(other);
+        }
+
+        poly_tree(poly_tree&& other) noexcept
+        {
+            move_from(std::move(other));
+        }
+
+        poly_tree& operator=(const poly_tree& other)
+        {
+            if (this != &other)
+            {
+                if (!other.is_copyable())
+                {
+                    throw std::logic_error(
+                        "Cannot copy poly_tree: contains non-copyable types");
+                }
+                clear();
+                copy_from(other);
+            }
+            return *this;
+        }
+
+        poly_tree& operator=(poly_tree&& other) noexcept
+        {
+            if (this != &other)
+            {
+                clear();
+                move_from(std::move(other));
+            }
+            return *this;
+        }
+
+        ~poly_tree()
+        {
+            clear();
+        }
+
+        // --- Structure modification ---
+
+        // Append a new root after the last tree of the forest
+        template <typename Derived, typename... Args>
+            requires FitsInSlot<Derived, NodeBase, SlotSize, Alignment> &&
+                     std::move_constructible<Derived> &&
+                     std::constructible_from<Derived, Args...>
+        size_type emplace_root(Args&&... args)
+        {
+            check_capacity("poly_tree::emplace_root() - capacity exceeded");
+            construct_back<Derived>(npos, std::forward<Args>(args)...);
+            return size_ - 1;
+        }
+
+        // Append a new node as the last child of parent; returns its index
+        template <typename Derived, typename... Args>
+            requires FitsInSlot<Derived, NodeBase, SlotSize, Alignment> &&
+                     std::move_constructible<Derived> &&
+                     std::constructible_from<Derived, Args...>
+        size_type emplace_child(size_type parent, Args&&... args)
+        {
+            check_index(parent, "poly_tree::emplace_child() - invalid parent");
+            check_capacity("poly_tree::emplace_child() - capacity exceeded");
+
+            // Construct at the end, then rotate into place: a throwing
+            // constructor leaves the tree unchanged
+            const size_type pos = subtree_end(parent);
+            construct_back<Derived>(parent, std::forward<Args>(args)...);
+            info_[size_ - 1].depth = info_[parent].depth + 1;
+            for (size_type a = parent; a != npos; a = info_[a].parent)
+            {
+                ++info_[a].subtree;
+            }
+            rotate_nodes(pos, size_ - 1, size_);
+            return pos;
+        }
+
+        // Destroy node and its whole subtree
+        void erase(size_type node)
+        {
+            check_index(node, "poly_tree::erase() - index out of bounds");
+            const size_type first = node;
+            const size_type last  = subtree_end(node);
+            const size_type count = last - first;
+
+            for (size_type a = info_[node].parent; a != npos;
+                 a            = info_[a].parent)
+            {
+                info_[a].subtree -= count;
+            }
+            for (size_type i = first; i < last; ++i)
+            {
+                destroy_node(i);
+            }
+
+            // Close the gap; nodes behind it keep their relative order
+            for (size_type i = last; i < size_; ++i)
+            {
+                safe_relocate(slot(i - count), slot(i), *info_[i].ops);
+                info_[i - count] = info_[i];
+            }
+            size_ -= count;
+            for (size_type i = first; i < size_; ++i)
+            {
+                if (info_[i].parent != npos && info_[i].parent >= last)
+                {
+                    info_[i].parent -= count;
+                }
+                refresh_ptr(i);
+            }
+        }
+
+        // Re-attach the subtree of node as the last child of new_parent
+        // (npos makes it the last root). Returns the node's new index.
+        size_type move_subtree(size_type node, size_type new_parent)
+        {
+            check_index(node, "poly_tree::move_subtree() - invalid node");
+            if (new_parent != npos)
+            {
+                check_index(new_parent,
+                            "poly_tree::move_subtree() - invalid parent");
+                if (is_ancestor_or_self(node, new_parent))
+                {
+                    throw std::invalid_argument(
+                        "poly_tree::move_subtree() - parent inside subtree");
+                }
+            }
+
+            const size_type first = node;
+            const size_type count = info_[node].subtree;
+            const size_type target =
+                new_parent == npos ? size_ : subtree_end(new_parent);
+
+            // Update sizes, parent and depths while indices are unchanged;
+            // common ancestors are decremented and incremented again
+            for (size_type a = info_[node].parent; a != npos;
+                 a            = info_[a].parent)
+            {
+                info_[a].subtree -= count;
+            }
+            for (size_type a = new_parent; a != npos; a = info_[a].parent)
+            {
+                info_[a].subtree += count;
+            }
+            const size_type old_depth = info_[node].depth;
+            const size_type new_depth =
+                new_parent == npos ? 0 : info_[new_parent].depth + 1;
+            for (size_type i = first; i < first + count; ++i)
+            {
+                info_[i].depth = info_[i].depth - old_depth + new_depth;
+            }
+            info_[node].parent = new_parent;
+
+            // The subtree already follows the new parent's subtree
+            if (target == first)
+            {
+                return first;
+            }
+            if (target < first)
+            {
+                rotate_nodes(target, first, first + count);
+                return target;
+            }
+            rotate_nodes(first, first + count, target);
+            return target - count;
+        }
+
+        void clear() noexcept
+        {
+            for (size_type i = size_; i > 0; --i)
+            {
+                destroy_node(i - 1);
+            }
+            size_ = 0;
+        }
+
+        // --- Navigation ---
+
+        [[nodiscard]] size_type parent(size_type node) const
+        {
+            check_index(node, "poly_tree::parent() - index out of bounds");
+            return info_[node].parent;
+        }
+
+        [[nodiscard]] size_type depth(size_type node) const
+        {
+            check_index(node, "poly_tree::depth() - index out of bounds");
+            return info_[node].depth;
+        }
+
+        // Number of nodes in the subtree rooted at node, including node
+        [[nodiscard]] size_type subtree_size(size_type node) const
+        {
+            check_index(node, "poly_tree::subtree_size() - index out of bounds");
+            return info_[node].subtree;
+        }
+
+        // One past the last node of the subtree; continue a pre-order scan
+        // here to skip the subtree
+        [[nodiscard]] size_type subtree_end(size_type node) const noexcept
+        {
+            return node + info_[node].subtree;
+        }
+
+        [[nodiscard]] size_type first_child(size_type node) const noexcept
+        {
+            return info_[node].subtree > 1 ? node + 1 : npos;
+        }
+
+        [[nodiscard]] size_type next_sibling(size_type node) const noexcept
+        {
+            const size_type next   = subtree_end(node);
+            const size_type parent = info_[node].parent;
+            const size_type limit  = parent == npos ? size_ : subtree_end(parent);
+            return next < limit ? next : npos;
+        }
+
+        [[nodiscard]] size_type child_count(size_type node) const noexcept
+        {
+            size_type count = 0;
+            for (size_type c = first_child(node); c != npos; c = next_sibling(c))
+            {
+                ++count;
+            }
+            return count;
+        }
+
+        // Whether descendant lies in the subtree rooted at ancestor
+        [[nodiscard]] bool
+        is_ancestor_or_self(size_type ancestor,
+                            size_type descendant) const noexcept
+        {
+            return descendant >= ancestor && descendant < subtree_end(ancestor);
+        }
+
+        // Call fn(index) for each direct child of node
+        template <typename Fn>
+        void for_each_child(size_type node, Fn&& fn) const
+        {
+            for (size_type c = first_child(node); c != npos; c = next_sibling(c))
+            {
+                fn(c);
+            }
+        }
+
+        // --- Access ---
+
+        [[nodiscard]] NodeBase& operator[](size_type node) noexcept
+        {
+            return *ptrs_[node];
+        }
+        [[nodiscard]] const NodeBase& operator[](size_type node) const noexcept
+        {
+            return *ptrs_[node];
+        }
+
+        [[nodiscard]] NodeBase& at(size_type node)
+        {
+            check_index(node, "poly_tree::at() - index out of bounds");
+            return *ptrs_[node];
+        }
+        [[nodiscard]] const NodeBase& at(size_type node) const
+        {
+            check_index(node, "poly_tree::at() - index out of bounds");
+            return *ptrs_[node];
+        }
+
+        template <typename Derived>
+        [[nodiscard]] bool holds(size_type node) const noexcept
+        {
+            return info_[node].ops == &get_type_ops<Derived>();
+        }
+
+        [[nodiscard]] size_type size() const noexcept
+        {
+            return size_;
+        }
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return size_ == 0;
+        }
+        [[nodiscard]] static constexpr size_type capacity() noexcept
+        {
+            return N;
+        }
+        [[nodiscard]] bool is_copyable() const noexcept
+        {
+            return non_copyable_ == 0;
+        }
+
+        // --- Iterators (pre-order) ---
+
+        iterator begin() noexcept
+        {
+            return ptrs_.data();
+        }
+        const_iterator begin() const noexcept
+        {
+            return ptrs_.data();
+        }
+        const_iterator cbegin() const noexcept
+        {
+            return begin();
+        }
+        iterator end() noexcept
+        {
+            return ptrs_.data() + size_;
+        }
+        const_iterator end() const noexcept
+        {
+            return ptrs_.data() + size_;
+        }
+        const_iterator cend() const noexcept
+        {
+            return end();
+        }
+        reverse_iterator rbegin() noexcept
+        {
+            return reverse_iterator(end());
+        }
+        const_reverse_iterator rbegin() const noexcept
+        {
+            return const_reverse_iterator(end());
+        }
+        reverse_iterator rend() noexcept
+        {
+            return reverse_iterator(begin());
+        }
+        const_reverse_iterator rend() const noexcept
+        {
+            return const_reverse_iterator(begin());
+        }
+
+    private:
+        std::byte* slot(size_type index) noexcept
+        {
+            return storage_ + index * SlotSize;
+        }
+        const std::byte* slot(size_type index) const noexcept
+        {
+            return storage_ + index * SlotSize;
+        }
+
+        void refresh_ptr(size_type index) noexcept
+        {
+            ptrs_[index] = std::launder(reinterpret_cast<NodeBase*>(
+                slot(index) + info_[index].base_offset));
+        }
+
+        void check_index(size_type index, const char* message) const
+        {
+            if (index >= size_)
+            {
+                throw std::out_of_range(message);
+            }
+        }
+
+        void check_capacity(const char* message) const
+        {
+            if (size_ >= N)
+            {
+                throw std::out_of_range(message);
+            }
+        }
+
+        template <typename Derived, typename... Args>
+        void construct_back(size_type parent, Args&&... args)
+        {
+            auto* obj = new (slot(size_)) Derived(std::forward<Args>(args)...);
+            NodeBase* base = obj;
+
+            info_[size_] = {
+                .ops         = &get_type_ops<Derived>(),
+                .parent      = parent,
+                .subtree     = 1,
+                .depth       = 0,
+                .base_offset = static_cast<size_type>(
+                    reinterpret_cast<std::byte*>(base) - slot(size_)),
+            };
+            ptrs_[size_] = base;
+            if (!info_[size_].ops->is_copy_constructible)
+            {
+                ++non_copyable_;
+            }
+            ++size_;
+        }
+
+        void destroy_node(size_type index) noexcept
+        {
+            if (!info_[index].ops->is_copy_constructible)
+            {
+                --non_copyable_;
+            }
+            safe_destroy(slot(index), *info_[index].ops);
+        }
+
+        // Rotate the nodes in [first, last) so that middle becomes first,
+        // relocating each object once through a single temporary slot
+        void rotate_nodes(size_type first, size_type middle, size_type last)
+        {
+            if (first == middle || middle == last)
+            {
+                return;
+            }
+            const size_type length = last - first;
+            const size_type shift  = middle - first;
+            alignas(Alignment) std::byte temp[SlotSize];
+
+            // Juggling rotation: one cycle per gcd step
+            for (size_type start = 0; start < std::gcd(length, shift); ++start)
+            {
+                const type_operations& held = *info_[first + start].ops;
+                safe_relocate(temp, slot(first + start), held);
+                size_type hole = start;
+                for (;;)
+                {
+                    size_type next = hole + shift;
+                    if (next >= length)
+                    {
+                        next -= length;
+                    }
+                    if (next == start)
+                    {
+                        break;
+                    }
+                    safe_relocate(slot(first + hole), slot(first + next),
+                                  *info_[first + next].ops);
+                    hole = next;
+                }
+                safe_relocate(slot(first + hole), temp, held);
+            }
+
+            std::rotate(info_.begin() + first, info_.begin() + middle,
+                        info_.begin() + last);
+
+            // Parents that pointed into the rotated range follow their nodes
+            const auto remap = [&](size_type index)
+            {
+                if (index == npos || index < first || index >= last)
+                {
+                    return index;
+                }
+                return index < middle ? index + (last - middle)
+                                      : index - shift;
+            };
+            for (size_type i = 0; i < size_; ++i)
+            {
+                info_[i].parent = remap(info_[i].parent);
+            }
+            for (size_type i = first; i < last; ++i)
+            {
+                refresh_ptr(i);
+            }
+        }
+
+        void copy_from(const poly_tree& other)
+        {
+            if (!other.is_copyable())
+            {
+                throw std::logic_error(
+                    "Cannot copy poly_tree: contains non-copyable types");
+            }
+            try
+            {
+                for (size_type i = 0; i < other.size_; ++i)
+                {
+                    safe_copy_construct(slot(i), other.slot(i),
+                                        *other.info_[i].ops);
+                    info_[i] = other.info_[i];
+                    refresh_ptr(i);
+                    ++size_;
+                }
+            }
+            catch (...)
+            {
+                clear();
+                throw;
+            }
+        }
+
+        void move_from(poly_tree&& other) noexcept
+        {
+            for (size_type i = 0; i < other.size_; ++i)
+            {
+                safe_relocate(slot(i), other.slot(i), *other.info_[i].ops);
+                info_[i] = other.info_[i];
+                refresh_ptr(i);
+            }
+            size_               = other.size_;
+            non_copyable_       = other.non_copyable_;
+            other.size_         = 0;
+            other.non_copyable_ = 0;
+        }
+    };
+
+    // Convenience alias
+    template <PolymorphicBase NodeBase, size_t N, size_t SlotSize,
+              size_t Alignment = alignof(std::max_align_t)>
+    using tree = poly_tree<NodeBase, N, SlotSize, Alignment>;
+
+} // namespace inline_poly
+
+#endif // INLINE_POLY_TREE_H
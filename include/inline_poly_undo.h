@@ -0,0 +1,359 @@
+// Copyright 2025 Dr. Matthias Hölzl
+
+// inline_poly_undo.h - Bounded undo/redo history of polymorphic commands
+//
+// poly_undo_history stores heterogeneous command objects in an inline ring
+// buffer of Bytes bytes instead of one heap allocation per edit. Commands
+// implement execute() and undo(). When a new command does not fit, the oldest
+// commands are evicted until it does, so the byte budget is never exceeded.
+// Executing a command after undoing discards the redo tail in one pass. If
+// Base provides `bool merge(Base& next)`, a new command is first offered to
+// the most recent one, which may absorb it in place (e.g. consecutive
+// keystrokes into one "typing" command).
+
+#pragma once
+#ifndef INLINE_POLY_UNDO_H
+#define INLINE_POLY_UNDO_H
+
+#include "inline_poly.h"
+
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+namespace inline_poly
+{
+
+    // Commands whose base class offers a merge hook
+    template <typename Base>
+    concept MergeableCommand = requires(Base& previous, Base& next) {
+        { previous.merge(next) } -> std::convertible_to<bool>;
+    };
+
+    template <PolymorphicBase Base, std::size_t Bytes>
+    class poly_undo_history
+    {
+    public:
+        static constexpr std::size_t record_alignment = alignof(std::max_align_t);
+
+        static_assert(Bytes % record_alignment == 0,
+                      "Bytes must be a multiple of alignof(std::max_align_t)");
+        static_assert(Bytes < std::numeric_limits<std::uint32_t>::max(),
+                      "Bytes exceeds the record offset range");
+
+    private:
+        static constexpr std::uint32_t npos =
+            std::numeric_limits<std::uint32_t>::max();
+
+        struct record_header
+        {
+            const type_operations* ops;
+            std::uint32_t          size; // Header + payload + padding
+            std::uint32_t          prev; // Older record, npos if oldest
+            std::uint32_t          next; // Newer record, npos if newest
+            std::int32_t           base_offset;
+        };
+
+        static constexpr std::size_t header_size =
+            (sizeof(record_header) + record_alignment - 1) / record_alignment *
+            record_alignment;
+
+        // Records live in [head_, tail_) modulo wrap-around; a record never
+        // straddles the end of the buffer
+        alignas(record_alignment) std::byte storage_[Bytes]{};
+        std::uint32_t head_    = 0;    // Oldest record
+        std::uint32_t tail_    = 0;    // End of the newest record
+        std::uint32_t newest_  = npos;
+        std::uint32_t current_ = npos; // Most recently applied record
+        std::size_t   count_   = 0;
+        std::size_t   applied_ = 0;
+        std::size_t   evicted_ = 0;
+
+    public:
+        poly_undo_history() = default;
+
+        poly_undo_history(const poly_undo_history&)            = delete;
+        poly_undo_history& operator=(const poly_undo_history&) = delete;
+
+        ~poly_undo_history()
+        {
+            clear();
+        }
+
+        // --- Editing ---
+
+        // Construct a command, execute() it and record it. Discards the redo
+        // tail; evicts the oldest commands if the budget is exhausted.
+        // Returns the command that now represents the edit (the previous one
+        // if it merged the new command).
+        template <typename Derived, typename... Args>
+            requires std::derived_from<Derived, Base> &&
+                     std::constructible_from<Derived, Args...>
+        Base& execute(Args&&... args)
+        {
+            static_assert(std::is_move_constructible_v<Derived>,
+                          "commands must be move constructible");
+            Derived command(std::forward<Args>(args)...);
+            command.execute();
+            return record<Derived>(std::move(command));
+        }
+
+        // Record a command whose effect has already been applied
+        template <typename Derived>
+            requires std::derived_from<std::remove_cvref_t<Derived>, Base>
+        Base& record(Derived&& command)
+        {
+            using T = std::remove_cvref_t<Derived>;
+            static_assert(alignof(T) <= record_alignment,
+                          "over-aligned commands are not supported");
+
+            constexpr std::size_t size = record_size(sizeof(T));
+            static_assert(size <= Bytes, "command larger than the history");
+
+            truncate_redo();
+
+            if constexpr (MergeableCommand<Base>)
+            {
+                if (current_ != npos)
+                {
+                    Base& previous = *base_at(current_);
+                    if (previous.merge(static_cast<Base&>(command)))
+                    {
+                        return previous;
+                    }
+                }
+            }
+
+            const std::uint32_t offset = allocate(size);
+            T* stored = new (storage_ + offset + header_size)
+                T(std::forward<Derived>(command));
+            new (storage_ + offset) record_header{
+                .ops         = &get_type_ops<T>(),
+                .size        = static_cast<std::uint32_t>(size),
+                .prev        = newest_,
+                .next        = npos,
+                .base_offset = static_cast<std::int32_t>(
+                    reinterpret_cast<std::byte*>(static_cast<Base*>(stored)) -
+                    reinterpret_cast<std::byte*>(stored))};
+
+            if (newest_ != npos)
+            {
+                header_at(newest_).next = offset;
+            }
+            else
+            {
+                head_ = offset;
+            }
+            newest_  = offset;
+            current_ = offset;
+            tail_    = static_cast<std::uint32_t>(offset + size);
+            ++count_;
+            ++applied_;
+            return *stored;
+        }
+
+        // Undo the most recent applied command; false if there is none
+        bool undo()
+        {
+            if (current_ == npos)
+            {
+                return false;
+            }
+            base_at(current_)->undo();
+            current_ = header_at(current_).prev;
+            --applied_;
+            return true;
+        }
+
+        // Re-execute the next undone command; false if there is none
+        bool redo()
+        {
+            const std::uint32_t next = first_redo();
+            if (next == npos)
+            {
+                return false;
+            }
+            base_at(next)->execute();
+            current_ = next;
+            ++applied_;
+            return true;
+        }
+
+        // Destroy all commands without undoing them
+        void clear() noexcept
+        {
+            while (count_ != 0)
+            {
+                evict_oldest();
+            }
+        }
+
+        // --- Queries ---
+
+        [[nodiscard]] bool can_undo() const noexcept
+        {
+            return applied_ != 0;
+        }
+        [[nodiscard]] bool can_redo() const noexcept
+        {
+            return applied_ != count_;
+        }
+        [[nodiscard]] std::size_t undo_count() const noexcept
+        {
+            return applied_;
+        }
+        [[nodiscard]] std::size_t redo_count() const noexcept
+        {
+            return count_ - applied_;
+        }
+        [[nodiscard]] std::size_t size() const noexcept
+        {
+            return count_;
+        }
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return count_ == 0;
+        }
+
+        // Commands dropped to stay within the budget since construction
+        [[nodiscard]] std::size_t evicted() const noexcept
+        {
+            return evicted_;
+        }
+
+        // The command the next undo() reverts, nullptr if none
+        [[nodiscard]] Base* top() noexcept
+        {
+            return current_ == npos ? nullptr : base_at(current_);
+        }
+
+        [[nodiscard]] static constexpr std::size_t capacity_bytes() noexcept
+        {
+            return Bytes;
+        }
+
+        // Bytes one command of the given size occupies, including its header
+        [[nodiscard]] static constexpr std::size_t
+        record_size(std::size_t object_size) noexcept
+        {
+            return header_size + (object_size + record_alignment - 1) /
+                                     record_alignment * record_alignment;
+        }
+
+    private:
+        record_header& header_at(std::uint32_t offset) noexcept
+        {
+            return *std::launder(
+                reinterpret_cast<record_header*>(storage_ + offset));
+        }
+
+        Base* base_at(std::uint32_t offset) noexcept
+        {
+            return std::launder(reinterpret_cast<Base*>(
+                storage_ + offset + header_size + header_at(offset).base_offset));
+        }
+
+        std::uint32_t first_redo() noexcept
+        {
+            if (applied_ == count_)
+            {
+                return npos;
+            }
+            return current_ == npos ? head_ : header_at(current_).next;
+        }
+
+        void destroy_record(std::uint32_t offset) noexcept
+        {
+            safe_destroy(storage_ + offset + header_size,
+                         *header_at(offset).ops);
+        }
+
+        // Destroy every undone command, newest first
+        void truncate_redo() noexcept
+        {
+            while (count_ != applied_)
+            {
+                const std::uint32_t prev = header_at(newest_).prev;
+                destroy_record(newest_);
+                --count_;
+                newest_ = prev;
+            }
+            if (newest_ == npos)
+            {
+                head_ = tail_ = 0;
+            }
+            else
+            {
+                header_at(newest_).next = npos;
+                tail_ = newest_ + header_at(newest_).size;
+            }
+        }
+
+        void evict_oldest() noexcept
+        {
+            const std::uint32_t next = header_at(head_).next;
+            if (current_ == head_)
+            {
+                current_ = npos;
+            }
+            if (applied_ != 0)
+            {
+                --applied_;
+            }
+            destroy_record(head_);
+            --count_;
+            ++evicted_;
+            if (next == npos)
+            {
+                head_ = tail_ = 0;
+                newest_ = current_ = npos;
+            }
+            else
+            {
+                header_at(next).prev = npos;
+                head_                = next;
+            }
+        }
+
+        // Find room for `size` contiguous bytes after the newest record,
+        // evicting the oldest records until it fits
+        std::uint32_t allocate(std::size_t size) noexcept
+        {
+            for (;;)
+            {
+                if (count_ == 0)
+                {
+                    return 0;
+                }
+                if (tail_ > head_)
+                {
+                    // Occupied [head_, tail_): use the end, else wrap to 0
+                    if (Bytes - tail_ >= size)
+                    {
+                        return tail_;
+                    }
+                    if (head_ >= size)
+                    {
+                        return 0;
+                    }
+                }
+                else if (head_ - tail_ >= size)
+                {
+                    // Wrapped: free space is [tail_, head_)
+                    return tail_;
+                }
+                evict_oldest();
+            }
+        }
+    };
+
+    // Convenience alias
+    template <PolymorphicBase Base, std::size_t Bytes>
+    using undo_history = poly_undo_history<Base, Bytes>;
+
+} // namespace inline_poly
+
+#endif // INLINE_POLY_UNDO_H
@@ -0,0 +1,266 @@
+// Copyright 2025 Dr. Matthias Hölzl
+
+// inline_poly_value.h - Single polymorphic object with inline storage
+//
+// poly_value holds at most one object derived from Base in an inline slot, so
+// a struct can embed a polymorphic member (a strategy, a policy, a shape)
+// without a unique_ptr indirection and keep it in its own cache lines. Copy,
+// move and destruction go through the stored object's type_operations; moving
+// a poly_value relocates the object and leaves the source empty.
+
+#pragma once
+#ifndef INLINE_POLY_VALUE_H
+#define INLINE_POLY_VALUE_H
+
+#include "inline_poly.h"
+
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace inline_poly
+{
+
+    template <PolymorphicBase Base, size_t SlotSize,
+              size_t Alignment = alignof(std::max_align_t)>
+    class poly_value
+    {
+    public:
+        static_assert(SlotSize >= sizeof(Base), "SlotSize must hold Base");
+        static_assert(Alignment >= alignof(Base),
+                      "Alignment must be at least alignof(Base)");
+
+        using base_type = Base;
+
+    private:
+        alignas(Alignment) std::byte storage_[SlotSize]{};
+        Base*                  ptr_ = nullptr;
+        const type_operations* ops_ = nullptr;
+
+    public:
+        poly_value() noexcept = default;
+
+        template <typename Derived, typename... Args>
+            requires FitsInSlot<Derived, Base, SlotSize, Alignment> &&
+                     std::constructible_from<Derived, Args...>
+        explicit poly_value(std::in_place_type_t<Derived>, Args&&... args)
+        {
+            emplace<Derived>(std::forward<Args>(args)...);
+        }
+
+        // Construct from a derived object, e.g. poly_value<Shape, 64>{Circle{}}
+        template <typename Derived>
+            requires(!std::is_same_v<std::remove_cvref_t<Derived>,
+                                     poly_value>) &&
+                    FitsInSlot<std::remove_cvref_t<Derived>, Base, SlotSize,
+                               Alignment>
+        poly_value(Derived&& value)
+        {
+            emplace<std::remove_cvref_t<Derived>>(std::forward<Derived>(value));
+        }
+
+        // Throws std::logic_error if the stored type is not copy constructible
+        poly_value(const poly_value& other)
+        {
+            copy_from(other);
+        }
+
+        poly_value(poly_value&& other) noexcept
+        {
+            move_from(std::move(other));
+        }
+
+        poly_value& operator=(const poly_value& other)
+        {
+            if (this != &other)
+            {
+                if (!other.is_copyable())
+                {
+                    throw std::logic_error("Cannot copy poly_value: "
+                                           "contains a non-copyable type");
+                }
+                reset();
+                copy_from(other);
+            }
+            return *this;
+        }
+
+        poly_value& operator=(poly_value&& other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                move_from(std::move(other));
+            }
+            return *this;
+        }
+
+        ~poly_value()
+        {
+            reset();
+        }
+
+        // --- Modifiers ---
+
+        // Replace the stored object. The old object is destroyed first, so
+        // the value is empty if the constructor throws.
+        template <typename Derived, typename... Args>
+            requires FitsInSlot<Derived, Base, SlotSize, Alignment> &&
+                     std::constructible_from<Derived, Args...>
+        Derived& emplace(Args&&... args)
+        {
+            reset();
+            auto* obj = new (storage_) Derived(std::forward<Args>(args)...);
+            ptr_      = obj;
+            ops_      = &get_type_ops<Derived>();
+            return *obj;
+        }
+
+        void reset() noexcept
+        {
+            if (ptr_)
+            {
+                safe_destroy(storage_, *ops_);
+                ptr_ = nullptr;
+                ops_ = nullptr;
+            }
+        }
+
+        void swap(poly_value& other) noexcept
+        {
+            if (this == &other)
+            {
+                return;
+            }
+            poly_value tmp(std::move(other));
+            other = std::move(*this);
+            *this = std::move(tmp);
+        }
+
+        friend void swap(poly_value& lhs, poly_value& rhs) noexcept
+        {
+            lhs.swap(rhs);
+        }
+
+        // --- Access ---
+
+        [[nodiscard]] bool has_value() const noexcept
+        {
+            return ptr_ != nullptr;
+        }
+
+        explicit operator bool() const noexcept
+        {
+            return has_value();
+        }
+
+        [[nodiscard]] Base* get() noexcept
+        {
+            return ptr_;
+        }
+        [[nodiscard]] const Base* get() const noexcept
+        {
+            return ptr_;
+        }
+
+        [[nodiscard]] Base* operator->() noexcept
+        {
+            return ptr_;
+        }
+        [[nodiscard]] const Base* operator->() const noexcept
+        {
+            return ptr_;
+        }
+
+        [[nodiscard]] Base& operator*() noexcept
+        {
+            return *ptr_;
+        }
+        [[nodiscard]] const Base& operator*() const noexcept
+        {
+            return *ptr_;
+        }
+
+        // Exact-type check by type_operations identity
+        template <typename Derived>
+        [[nodiscard]] bool holds() const noexcept
+        {
+            return ops_ == &get_type_ops<Derived>();
+        }
+
+        template <typename Derived>
+        [[nodiscard]] Derived* get_if() noexcept
+        {
+            return holds<Derived>() ? static_cast<Derived*>(ptr_) : nullptr;
+        }
+        template <typename Derived>
+        [[nodiscard]] const Derived* get_if() const noexcept
+        {
+            return holds<Derived>() ? static_cast<const Derived*>(ptr_)
+                                    : nullptr;
+        }
+
+        // Operations of the stored type, nullptr when empty
+        [[nodiscard]] const type_operations* type_ops() const noexcept
+        {
+            return ops_;
+        }
+
+        [[nodiscard]] bool is_copyable() const noexcept
+        {
+            return !ptr_ || ops_->is_copy_constructible;
+        }
+
+        [[nodiscard]] static constexpr size_t slot_size() noexcept
+        {
+            return SlotSize;
+        }
+
+    private:
+        // Base pointer at the same offset into storage_ as in other
+        Base* rebase(const poly_value& other) noexcept
+        {
+            const auto offset =
+                reinterpret_cast<const std::byte*>(other.ptr_) - other.storage_;
+            return std::launder(reinterpret_cast<Base*>(storage_ + offset));
+        }
+
+        void copy_from(const poly_value& other)
+        {
+            if (!other.ptr_)
+            {
+                return;
+            }
+            if (!other.ops_->is_copy_constructible)
+            {
+                throw std::logic_error("Cannot copy poly_value: "
+                                       "contains a non-copyable type");
+            }
+            safe_copy_construct(storage_, other.storage_, *other.ops_);
+            ptr_ = rebase(other);
+            ops_ = other.ops_;
+        }
+
+        void move_from(poly_value&& other) noexcept
+        {
+            if (!other.ptr_)
+            {
+                return;
+            }
+            safe_relocate(storage_, other.storage_, *other.ops_);
+            ptr_       = rebase(other);
+            ops_       = other.ops_;
+            other.ptr_ = nullptr;
+            other.ops_ = nullptr;
+        }
+    };
+
+    // Convenience alias
+    template <PolymorphicBase Base, size_t SlotSize,
+              size_t Alignment = alignof(std::max_align_t)>
+    using value = poly_value<Base, SlotSize, Alignment>;
+
+} // namespace inline_poly
+
+#endif // INLINE_POLY_VALUE_H
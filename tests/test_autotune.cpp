@@ -0,0 +1,139 @@
+// Copyright 2025 Dr. Matthias Hölzl
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <array>
+#include "../include/inline_poly_autotune.h"
+
+struct Node
+{
+    virtual ~Node() = default;
+};
+
+struct Small : Node
+{
+    int value = 0;
+};
+
+struct Medium : Node
+{
+    double values[6]{};
+};
+
+struct Huge : Node
+{
+    double values[30]{};
+};
+
+using NodeTypes = inline_poly::type_list<Small, Medium, Huge>;
+
+TEST_CASE("autotune - Histogram reports sizes and alignments from type_list")
+{
+    inline_poly::type_histogram<NodeTypes> histogram;
+    auto                                   footprints = histogram.footprints();
+
+    REQUIRE(footprints.size() == 3);
+    CHECK(footprints[0].size == sizeof(Small));
+    CHECK(footprints[1].size == sizeof(Medium));
+    CHECK(footprints[2].size == sizeof(Huge));
+    CHECK(footprints[2].alignment == alignof(Huge));
+    CHECK(histogram.total() == 0);
+}
+
+TEST_CASE("autotune - Histogram observes container contents")
+{
+    inline_poly::vector<Node, 16, inline_poly::max_size_v<NodeTypes>> nodes;
+    nodes.emplace_back<Small>();
+    nodes.emplace_back<Small>();
+    nodes.emplace_back<Huge>();
+
+    inline_poly::type_histogram<NodeTypes> histogram;
+    histogram.observe(nodes);
+    histogram.add<Medium>(5);
+
+    auto footprints = histogram.footprints();
+    CHECK(footprints[0].count == 2);
+    CHECK(footprints[1].count == 5);
+    CHECK(footprints[2].count == 1);
+    CHECK(histogram.total() == 8);
+}
+
+TEST_CASE("autotune - Uniform sizes recommend a single slot")
+{
+    const std::array<inline_poly::type_footprint, 2> types = {{
+        {.name = "A", .size = 32, .alignment = 8, .count = 100},
+        {.name = "B", .size = 32, .alignment = 8, .count = 50},
+    }};
+
+    const auto result = inline_poly::recommend_slots(types);
+    CHECK(result.recommended.strategy == inline_poly::slot_strategy::single_slot);
+    CHECK(result.single.slot_sizes[0] == 32);
+    CHECK(result.single.projected_bytes == 150 * 32);
+    CHECK(result.single.cache_lines == (150 * 32 + 63) / 64);
+}
+
+TEST_CASE("autotune - Bimodal sizes recommend size classes")
+{
+    const std::array<inline_poly::type_footprint, 3> types = {{
+        {.name = "small", .size = 16, .alignment = 8, .count = 1000},
+        {.name = "medium", .size = 24, .alignment = 8, .count = 900},
+        {.name = "huge", .size = 256, .alignment = 16, .count = 10},
+    }};
+
+    const auto result = inline_poly::recommend_slots(types);
+    CHECK(result.single.projected_bytes == 1910 * 256);
+    CHECK(result.recommended.strategy ==
+          inline_poly::slot_strategy::size_classes);
+    CHECK(result.split.class_count == 3);
+    CHECK(result.split.slot_sizes[0] == 16);
+    CHECK(result.split.slot_sizes[1] == 24);
+    CHECK(result.split.slot_sizes[2] == 256);
+    CHECK(result.split.slot_alignments[2] == 16);
+    CHECK(result.split.projected_bytes == 1000 * 16 + 900 * 24 + 10 * 256);
+
+    SUBCASE("two classes merge the closest sizes")
+    {
+        inline_poly::autotune_options options;
+        options.max_classes = 2;
+        const auto two      = inline_poly::recommend_slots(types, options);
+        CHECK(two.split.class_count == 2);
+        CHECK(two.split.slot_sizes[0] == 24);
+        CHECK(two.split.slot_sizes[1] == 256);
+    }
+}
+
+TEST_CASE("autotune - Rare huge type spills to the heap without size classes")
+{
+    const std::array<inline_poly::type_footprint, 2> types = {{
+        {.name = "small", .size = 16, .alignment = 8, .count = 10000},
+        {.name = "huge", .size = 1024, .alignment = 8, .count = 2},
+    }};
+
+    inline_poly::autotune_options options;
+    options.max_classes = 1;
+    const auto result   = inline_poly::recommend_slots(types, options);
+
+    CHECK(result.recommended.strategy == inline_poly::slot_strategy::overflow);
+    CHECK(result.overflow.slot_sizes[0] == 16);
+    CHECK(result.overflow.overflow_count == 2);
+    CHECK(result.overflow.slot_counts[0] == 10002);
+    CHECK(result.overflow.projected_bytes ==
+          10002 * 16 + 2 * (1024 + options.heap_overhead));
+}
+
+TEST_CASE("autotune - Empty input is rejected")
+{
+    CHECK_THROWS_AS(inline_poly::recommend_slots(
+                        std::span<const inline_poly::type_footprint>{}),
+                    std::invalid_argument);
+}
+
+TEST_CASE("autotune - Zero cache line size is rejected")
+{
+    const std::array<inline_poly::type_footprint, 1> types = {{
+        {.name = "A", .size = 32, .alignment = 8, .count = 1},
+    }};
+    CHECK_THROWS_AS(
+        inline_poly::recommend_slots(types, {.cache_line_size = 0}),
+        std::invalid_argument);
+}
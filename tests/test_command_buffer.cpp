@@ -0,0 +1,179 @@
+// Copyright 2025 Dr. Matthias Hölzl
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../include/inline_poly_command_buffer.h"
+
+struct Command
+{
+    virtual ~Command()                                  = default;
+    virtual void execute(std::vector<std::string>& log) = 0;
+};
+
+struct Clear : Command
+{
+    void execute(std::vector<std::string>& log) override
+    {
+        log.push_back("clear");
+    }
+};
+
+struct Draw : Command
+{
+    int    mesh;
+    double transform[8]{};
+    explicit Draw(int m) : mesh(m) {}
+    void execute(std::vector<std::string>& log) override
+    {
+        log.push_back("draw " + std::to_string(mesh));
+    }
+};
+
+struct Label : Command
+{
+    std::string          text;
+    std::shared_ptr<int> counter;
+    Label(std::string t, std::shared_ptr<int> c) :
+        text(std::move(t)), counter(std::move(c))
+    {}
+    void execute(std::vector<std::string>& log) override
+    {
+        log.push_back("label " + text);
+    }
+};
+
+// A second base in front of Command moves the Command subobject
+struct Tagged
+{
+    virtual ~Tagged() = default;
+    int tag           = 7;
+};
+
+struct Offset : Tagged, Command
+{
+    void execute(std::vector<std::string>& log) override
+    {
+        log.push_back("offset " + std::to_string(tag));
+    }
+};
+
+using Buffer = inline_poly::poly_command_buffer<Command, 1024>;
+
+TEST_CASE("command_buffer - Records are bump-allocated")
+{
+    Buffer buffer;
+    CHECK(buffer.empty());
+
+    buffer.emplace_back<Clear>();
+    CHECK(buffer.bytes_used() == Buffer::record_size(sizeof(Clear)));
+    buffer.emplace_back<Draw>(3);
+    CHECK(buffer.bytes_used() == Buffer::record_size(sizeof(Clear)) +
+                                     Buffer::record_size(sizeof(Draw)));
+    CHECK(buffer.size() == 2);
+    CHECK(Buffer::record_size(sizeof(Clear)) <
+          Buffer::record_size(sizeof(Draw)));
+}
+
+TEST_CASE("command_buffer - Replay runs commands in recording order")
+{
+    Buffer buffer;
+    auto   counter = std::make_shared<int>(0);
+    buffer.emplace_back<Clear>();
+    buffer.emplace_back<Draw>(1);
+    buffer.emplace_back<Label>("hud", counter);
+    buffer.emplace_back<Offset>();
+    buffer.emplace_back<Draw>(2);
+
+    std::vector<std::string> log;
+    buffer.replay(log);
+    CHECK(log == std::vector<std::string>{"clear", "draw 1", "label hud",
+                                          "offset 7", "draw 2"});
+
+    // Replay does not consume the commands
+    log.clear();
+    buffer.replay(log);
+    CHECK(log.size() == 5);
+
+    SUBCASE("reset destroys commands and reuses storage")
+    {
+        CHECK(counter.use_count() == 2);
+        buffer.reset();
+        CHECK(counter.use_count() == 1);
+        CHECK(buffer.empty());
+        CHECK(buffer.bytes_used() == 0);
+
+        buffer.emplace_back<Draw>(9);
+        log.clear();
+        buffer.replay(log);
+        CHECK(log == std::vector<std::string>{"draw 9"});
+    }
+}
+
+TEST_CASE("command_buffer - Full buffer")
+{
+    inline_poly::poly_command_buffer<Command, 128> small;
+    REQUIRE(small.try_emplace_back<Draw>(1) != nullptr);
+    CHECK(small.try_emplace_back<Draw>(2) == nullptr);
+    CHECK_THROWS_AS(small.emplace_back<Draw>(3), std::out_of_range);
+    CHECK(small.size() == 1);
+}
+
+TEST_CASE("command_buffer - Buffers recorded in parallel are concatenated")
+{
+    using ThreadBuffer = inline_poly::poly_command_buffer<Command, 512>;
+    auto         counter = std::make_shared<int>(0);
+    ThreadBuffer per_thread[3];
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 3; ++t)
+    {
+        workers.emplace_back(
+            [&, t]
+            {
+                per_thread[t].emplace_back<Draw>(t);
+                per_thread[t].emplace_back<Label>(std::to_string(t), counter);
+            });
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    Buffer merged;
+    merged.emplace_back<Clear>();
+    for (auto& buffer : per_thread)
+    {
+        merged.append(std::move(buffer));
+        CHECK(buffer.empty());
+    }
+    CHECK(merged.size() == 7);
+    CHECK(counter.use_count() == 4);
+
+    std::vector<std::string> log;
+    merged.replay(log);
+    CHECK(log == std::vector<std::string>{"clear", "draw 0", "label 0",
+                                          "draw 1", "label 1", "draw 2",
+                                          "label 2"});
+
+    SUBCASE("append fails atomically when the target is full")
+    {
+        inline_poly::poly_command_buffer<Command, 64> tiny;
+        ThreadBuffer                                  source;
+        source.emplace_back<Draw>(5);
+        CHECK_THROWS_AS(tiny.append(std::move(source)), std::out_of_range);
+        CHECK(source.size() == 1);
+        CHECK(tiny.empty());
+    }
+
+    SUBCASE("move construction transfers the commands")
+    {
+        Buffer moved = std::move(merged);
+        CHECK(merged.empty());
+        CHECK(moved.size() == 7);
+        CHECK(counter.use_count() == 4);
+    }
+}
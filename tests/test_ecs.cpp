@@ -0,0 +1,274 @@
+// Copyright 2025 Dr. Matthias Hölzl
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include "../include/inline_poly_ecs.h"
+
+namespace ecs = inline_poly::ecs;
+
+struct Position
+{
+    float x = 0, y = 0;
+};
+
+struct Velocity
+{
+    float dx = 0, dy = 0;
+};
+
+struct Name
+{
+    std::string value;
+};
+
+struct Owned
+{
+    std::unique_ptr<int> resource;
+};
+
+using Components = inline_poly::type_list<Position, Velocity, Name, Owned>;
+using World      = ecs::world<Components, 64, 8, 64>;
+
+TEST_CASE("ecs - Component ids and masks")
+{
+    CHECK(World::component_id<Position> == 0);
+    CHECK(World::component_id<Owned> == 3);
+    CHECK(World::mask_of<Position, Velocity> == 0b11);
+    CHECK_FALSE(World::is_component<int>);
+}
+
+TEST_CASE("ecs - Entities use generational handles")
+{
+    World world;
+    ecs::entity a = world.create();
+    CHECK(world.alive(a));
+    CHECK(world.size() == 1);
+
+    world.destroy(a);
+    CHECK_FALSE(world.alive(a));
+    CHECK(world.empty());
+
+    ecs::entity b = world.create();
+    CHECK(b.index == a.index);
+    CHECK(b.generation == a.generation + 1);
+    CHECK_FALSE(world.alive(a));
+    CHECK(world.alive(b));
+    CHECK_THROWS_AS(world.destroy(a), std::invalid_argument);
+    CHECK(world.get<Position>(a) == nullptr);
+}
+
+TEST_CASE("ecs - Adding and removing components changes archetypes")
+{
+    World world;
+    ecs::entity e = world.create(Position{1, 2}, Name{"ship"});
+    CHECK(world.archetype_count() == 2); // {} and {Position, Name}
+    CHECK(world.has<Position>(e));
+    CHECK_FALSE(world.has<Velocity>(e));
+
+    world.add<Velocity>(e, 3.0f, 4.0f);
+    REQUIRE(world.get<Velocity>(e) != nullptr);
+    CHECK(world.get<Velocity>(e)->dy == 4.0f);
+    CHECK(world.get<Position>(e)->x == 1.0f);
+    CHECK(world.get<Name>(e)->value == "ship");
+
+    SUBCASE("add replaces an existing component in place")
+    {
+        const std::size_t archetypes = world.archetype_count();
+        world.add<Position>(e, 7.0f, 8.0f);
+        CHECK(world.get<Position>(e)->x == 7.0f);
+        CHECK(world.archetype_count() == archetypes);
+    }
+
+    SUBCASE("a throwing replacement keeps the old component")
+    {
+        struct Exploding
+        {
+            operator std::string() const
+            {
+                throw std::runtime_error("no name");
+            }
+        };
+        world.add<Name>(e, "a name too long for the small string buffer");
+        CHECK_THROWS_AS(world.add<Name>(e, Exploding{}), std::runtime_error);
+        CHECK(world.get<Name>(e)->value ==
+              "a name too long for the small string buffer");
+    }
+
+    SUBCASE("remove keeps the remaining components")
+    {
+        world.remove<Position>(e);
+        CHECK_FALSE(world.has<Position>(e));
+        CHECK(world.get<Name>(e)->value == "ship");
+        CHECK(world.get<Velocity>(e)->dx == 3.0f);
+        world.remove<Position>(e); // absent: no-op
+        CHECK(world.alive(e));
+    }
+}
+
+TEST_CASE("ecs - Archetypes only store columns for their own components")
+{
+    // Reserving every component type in every archetype would take this
+    constexpr std::size_t all_columns =
+        8 * 64 * (sizeof(Position) + sizeof(Velocity) + sizeof(Name) +
+                  sizeof(Owned));
+    CHECK(sizeof(World) < all_columns);
+
+    using Small = ecs::world<Components, 16, 8, 16,
+                             16 * (sizeof(Position) + sizeof(Velocity))>;
+    Small       world;
+    ecs::entity e = world.create(Position{1, 2}, Velocity{3, 4});
+    world.create(); // The empty archetype has no columns
+    CHECK(world.archetype_count() == 2);
+
+    CHECK_THROWS_AS(world.create(Name{"no room"}), std::out_of_range);
+    CHECK_THROWS_AS(world.remove<Velocity>(e), std::out_of_range);
+    CHECK(world.archetype_count() == 2);
+    CHECK(world.size() == 2);
+    CHECK(world.get<Velocity>(e)->dy == 4.0f);
+}
+
+TEST_CASE("ecs - Swap-remove keeps other handles valid")
+{
+    World                      world;
+    std::array<ecs::entity, 5> entities{};
+    for (int i = 0; i < 5; ++i)
+    {
+        entities[i] = world.create(Position{float(i), 0},
+                                   Owned{std::make_unique<int>(i)});
+    }
+
+    world.destroy(entities[1]);
+    world.remove<Owned>(entities[0]);
+
+    for (int i = 2; i < 5; ++i)
+    {
+        REQUIRE(world.alive(entities[i]));
+        CHECK(world.get<Position>(entities[i])->x == float(i));
+        CHECK(*world.get<Owned>(entities[i])->resource == i);
+    }
+    CHECK(world.get<Position>(entities[0])->x == 0.0f);
+    CHECK(world.size() == 4);
+}
+
+TEST_CASE("ecs - Queries visit every matching archetype")
+{
+    World world;
+    for (int i = 0; i < 10; ++i)
+    {
+        ecs::entity e = world.create(Position{0, 0}, Velocity{1, float(i)});
+        if (i % 2 == 0)
+        {
+            world.add<Name>(e, std::to_string(i));
+        }
+    }
+    world.create(Position{5, 5}); // no velocity: not visited
+
+    auto moving = world.query<Position, const Velocity>();
+    CHECK(moving.count() == 10);
+
+    moving.each(
+        [](Position& p, const Velocity& v)
+        {
+            p.x += v.dx;
+            p.y += v.dy;
+        });
+
+    float       sum_y  = 0;
+    std::size_t chunks = 0;
+    world.query<const Position>().each_chunk(
+        [&](std::size_t count, const Position* positions)
+        {
+            ++chunks;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                sum_y += positions[i].y;
+            }
+        });
+    CHECK(chunks == 3);
+    CHECK(sum_y == doctest::Approx(45.0 + 5.0));
+
+    std::size_t named = 0;
+    world.query<Name>().each_with_entity(
+        [&](ecs::entity e, Name&)
+        {
+            CHECK(world.has<Velocity>(e));
+            ++named;
+        });
+    CHECK(named == 5);
+}
+
+TEST_CASE("ecs - Command buffer defers structural changes")
+{
+    World world;
+    for (int i = 0; i < 6; ++i)
+    {
+        world.create(Position{float(i), 0}, Velocity{});
+    }
+
+    ecs::command_buffer<World, 512> commands(world);
+    world.query<const Position>().each_with_entity(
+        [&](ecs::entity e, const Position& p)
+        {
+            if (int(p.x) % 2 == 0)
+            {
+                commands.destroy(e);
+            }
+            else
+            {
+                commands.add<Name>(e, "odd");
+                commands.remove<Velocity>(e);
+            }
+        });
+    CHECK(commands.size() == 9);
+    CHECK(world.size() == 6);
+
+    commands.flush();
+    CHECK(commands.empty());
+    CHECK(world.size() == 3);
+    CHECK(world.query<Velocity>().count() == 0);
+    CHECK(world.query<Position, Name>().count() == 3);
+
+    SUBCASE("commands for stale entities are skipped")
+    {
+        ecs::entity e = commands.create();
+        commands.add<Owned>(e, std::make_unique<int>(1));
+        commands.destroy(e);
+        commands.add<Name>(e, "late");
+        commands.flush();
+        CHECK_FALSE(world.alive(e));
+    }
+
+    SUBCASE("discard destroys pending payloads")
+    {
+        ecs::entity e = commands.create();
+        commands.add<Owned>(e, std::make_unique<int>(2));
+        commands.discard();
+        CHECK_FALSE(world.has<Owned>(e));
+    }
+
+    SUBCASE("entity capacity is enforced")
+    {
+        while (world.size() < World::capacity())
+        {
+            world.create(Velocity{});
+        }
+        CHECK_THROWS_AS(world.create(), std::out_of_range);
+        CHECK_THROWS_AS(world.create(Velocity{}), std::out_of_range);
+    }
+
+    SUBCASE("overflow throws")
+    {
+        ecs::entity e = commands.create();
+        auto fill = [&]
+        {
+            for (int i = 0; i < 100; ++i)
+            {
+                commands.add<Name>(e, "x");
+            }
+        };
+        CHECK_THROWS_AS(fill(), std::out_of_range);
+    }
+}
@@ -0,0 +1,166 @@
+// Copyright 2025 Dr. Matthias Hölzl
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "../include/inline_poly_event_bus.h"
+
+struct Event
+{
+    virtual ~Event() = default;
+};
+
+struct KeyPressed : Event
+{
+    int key;
+    explicit KeyPressed(int k) : key(k) {}
+};
+
+struct MouseMoved : Event
+{
+    double x, y;
+    MouseMoved(double x_, double y_) : x(x_), y(y_) {}
+};
+
+struct Message : Event
+{
+    std::string          text;
+    std::shared_ptr<int> tracker;
+    Message(std::string t, std::shared_ptr<int> tr) :
+        text(std::move(t)), tracker(std::move(tr))
+    {}
+};
+
+using Events = inline_poly::type_list<KeyPressed, MouseMoved, Message>;
+using Bus    = inline_poly::event_bus<Event, Events, 2048, 4>;
+
+static int g_function_calls = 0;
+static void count_keys(const KeyPressed&)
+{
+    ++g_function_calls;
+}
+
+TEST_CASE("event_bus - Dense type indices")
+{
+    CHECK(Bus::type_index<KeyPressed> == 0);
+    CHECK(Bus::type_index<Message> == 2);
+    CHECK_FALSE(Bus::is_event<Event>);
+}
+
+TEST_CASE("event_bus - Dispatch groups events by type")
+{
+    Bus                      bus;
+    std::vector<std::string> log;
+
+    auto on_key   = [&](const KeyPressed& e)
+    { log.push_back("key " + std::to_string(e.key)); };
+    auto on_mouse = [&](const MouseMoved& e)
+    { log.push_back("mouse " + std::to_string(int(e.x))); };
+    auto audit    = [&](const KeyPressed&) { log.push_back("audit"); };
+
+    bus.subscribe<KeyPressed>(on_key);
+    bus.subscribe<MouseMoved>(on_mouse);
+    bus.subscribe<KeyPressed>(audit);
+    CHECK(bus.subscriber_count<KeyPressed>() == 2);
+
+    bus.publish<MouseMoved>(1.0, 2.0);
+    bus.publish<KeyPressed>(10);
+    bus.publish<MouseMoved>(3.0, 4.0);
+    bus.publish<KeyPressed>(11);
+    CHECK(bus.size() == 4);
+    CHECK(bus.queued<KeyPressed>() == 2);
+
+    bus.dispatch();
+    CHECK(log == std::vector<std::string>{"key 10", "key 11", "audit", "audit",
+                                          "mouse 1", "mouse 3"});
+    CHECK(bus.empty());
+    CHECK(bus.bytes_used() == 0);
+}
+
+TEST_CASE("event_bus - Function subscribers and unsubscribe")
+{
+    Bus bus;
+    int lambda_calls = 0;
+    auto counter     = [&](const KeyPressed&) { ++lambda_calls; };
+
+    g_function_calls = 0;
+    auto function_id = bus.subscribe<KeyPressed>(&count_keys);
+    auto lambda_id   = bus.subscribe<KeyPressed>(counter);
+
+    bus.publish<KeyPressed>(1);
+    bus.dispatch();
+    CHECK(g_function_calls == 1);
+    CHECK(lambda_calls == 1);
+
+    // Removing one subscription leaves the other's id valid
+    bus.unsubscribe(function_id);
+    bus.publish<KeyPressed>(2);
+    bus.dispatch();
+    CHECK(g_function_calls == 1);
+    CHECK(lambda_calls == 2);
+
+    bus.unsubscribe(lambda_id);
+    CHECK(bus.subscriber_count<KeyPressed>() == 0);
+    CHECK_THROWS_AS(bus.unsubscribe(lambda_id), std::out_of_range);
+
+    // Freed slots are reused
+    auto again = bus.subscribe<KeyPressed>(counter);
+    CHECK(again.slot == 0);
+}
+
+TEST_CASE("event_bus - Events published during dispatch are kept")
+{
+    Bus  bus;
+    auto tracker = std::make_shared<int>(0);
+    int  replies = 0;
+
+    auto reply = [&](const KeyPressed& e)
+    {
+        if (e.key < 3)
+        {
+            bus.publish<Message>(std::string(100, 'x'), tracker);
+            bus.publish<KeyPressed>(e.key + 1);
+        }
+    };
+    auto count_messages = [&](const Message&) { ++replies; };
+    bus.subscribe<KeyPressed>(reply);
+    bus.subscribe<Message>(count_messages);
+
+    bus.publish<KeyPressed>(0);
+    bus.dispatch();
+    CHECK(replies == 0);
+    CHECK(bus.size() == 2);
+    CHECK(tracker.use_count() == 2);
+
+    bus.dispatch();
+    CHECK(replies == 1);
+    bus.dispatch();
+    bus.dispatch();
+    CHECK(replies == 3);
+    CHECK(bus.size() == 0);
+    CHECK(tracker.use_count() == 1);
+}
+
+TEST_CASE("event_bus - Limits and cleanup")
+{
+    auto tracker = std::make_shared<int>(0);
+    {
+        inline_poly::event_bus<Event, Events, 256, 1> bus;
+        auto handler = [](const Message&) {};
+        bus.subscribe<Message>(handler);
+        CHECK_THROWS_AS(bus.subscribe<Message>(handler), std::out_of_range);
+
+        auto fill = [&]
+        {
+            for (int i = 0; i < 100; ++i)
+            {
+                bus.publish<Message>("m", tracker);
+            }
+        };
+        CHECK_THROWS_AS(fill(), std::out_of_range);
+        CHECK(tracker.use_count() > 1);
+    }
+    CHECK(tracker.use_count() == 1);
+}
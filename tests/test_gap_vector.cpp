@@ -0,0 +1,215 @@
+// Copyright 2025 Dr. Matthias Hölzl
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include "../include/inline_poly_gap_vector.h"
+
+struct Glyph
+{
+    virtual ~Glyph()             = default;
+    virtual char symbol() const = 0;
+};
+
+struct Letter : Glyph
+{
+    char c;
+    explicit Letter(char ch) : c(ch) {}
+    char symbol() const override
+    {
+        return c;
+    }
+};
+
+struct Space : Glyph
+{
+    char symbol() const override
+    {
+        return ' ';
+    }
+};
+
+struct Marker : Glyph
+{
+    std::shared_ptr<int> tracker;
+    explicit Marker(std::shared_ptr<int> t) : tracker(std::move(t)) {}
+    char symbol() const override
+    {
+        return '#';
+    }
+};
+
+struct Locked : Glyph
+{
+    std::unique_ptr<int> value = std::make_unique<int>(1);
+    char                 symbol() const override
+    {
+        return '!';
+    }
+};
+
+// Letter and Space only hold plain data, so moving their bytes is a valid
+// relocation
+template <>
+struct inline_poly::is_trivially_relocatable<Letter> : std::true_type
+{};
+template <>
+struct inline_poly::is_trivially_relocatable<Space> : std::true_type
+{};
+
+using Text = inline_poly::gap_vector<Glyph, 16, 32, 8>;
+
+static std::string to_string(const Text& text)
+{
+    std::string result;
+    for (const Glyph* glyph : text)
+    {
+        result += glyph->symbol();
+    }
+    return result;
+}
+
+static void type(Text& text, const std::string& chars)
+{
+    for (char c : chars)
+    {
+        if (c == ' ')
+        {
+            text.insert<Space>();
+        }
+        else
+        {
+            text.insert<Letter>(c);
+        }
+    }
+}
+
+TEST_CASE("gap_vector - Typing and deleting at the cursor")
+{
+    Text text;
+    CHECK(text.empty());
+    CHECK(text.capacity() == 16);
+
+    type(text, "helo world");
+    CHECK(to_string(text) == "helo world");
+    CHECK(text.cursor() == 10);
+
+    text.move_cursor(3);
+    type(text, "l");
+    CHECK(to_string(text) == "hello world");
+    CHECK(text.cursor() == 4);
+
+    text.erase_before(); // Backspace removes the inserted 'l'
+    CHECK(to_string(text) == "helo world");
+    text.erase_after(); // Delete removes the 'o'
+    CHECK(to_string(text) == "hel world");
+    CHECK(text.cursor() == 3);
+
+    text.erase(0);
+    CHECK(to_string(text) == "el world");
+    text.insert_at<Letter>(8, '!');
+    CHECK(to_string(text) == "el world!");
+    CHECK(text.size() == 9);
+
+    CHECK(text[1]->symbol() == 'l');
+    CHECK(text.holds<Space>(2));
+    CHECK_THROWS_AS((void)text.at(9), std::out_of_range);
+    CHECK_THROWS_AS(text.move_cursor(10), std::out_of_range);
+    CHECK_THROWS_AS(text.erase_after(), std::out_of_range);
+
+    text.move_cursor(0);
+    CHECK_THROWS_AS(text.erase_before(), std::out_of_range);
+
+    text.clear();
+    CHECK(text.empty());
+    CHECK(text.cursor() == 0);
+}
+
+TEST_CASE("gap_vector - Capacity and iteration around the gap")
+{
+    Text text;
+    for (int i = 0; i < 16; ++i)
+    {
+        text.insert<Letter>(static_cast<char>('a' + i));
+    }
+    CHECK_THROWS_AS(text.insert<Space>(), std::out_of_range);
+
+    text.move_cursor(5);
+    text.erase_after();
+    text.erase_after();
+    CHECK(to_string(text) == "abcdehijklmnop");
+
+    // Iterators are bidirectional and see logical positions
+    auto it = text.end();
+    --it;
+    CHECK((*it)->symbol() == 'p');
+    CHECK(it.index() == 13);
+    std::size_t count = 0;
+    for (auto i = text.cbegin(); i != text.cend(); ++i)
+    {
+        ++count;
+    }
+    CHECK(count == 14);
+}
+
+TEST_CASE("gap_vector - Cursor moves relocate only the traversed elements")
+{
+    Text text;
+    type(text, "abc def");
+    CHECK(text.is_trivially_relocatable());
+
+    // Memmove path: element addresses follow the gap
+    const Glyph* before = text[2];
+    text.move_cursor(1);
+    CHECK(text[2] != before);
+    CHECK(text[2]->symbol() == 'c');
+    text.move_cursor(7);
+    CHECK(to_string(text) == "abc def");
+
+    // One non-trivially-relocatable element switches to per-element moves
+    auto tracker = std::make_shared<int>(0);
+    text.insert_at<Marker>(3, tracker);
+    CHECK_FALSE(text.is_trivially_relocatable());
+    text.move_cursor(0);
+    text.move_cursor(8);
+    CHECK(to_string(text) == "abc# def");
+    CHECK(tracker.use_count() == 2);
+
+    text.erase(3);
+    CHECK(text.is_trivially_relocatable());
+    CHECK(tracker.use_count() == 1);
+}
+
+TEST_CASE("gap_vector - Copy, move and cleanup")
+{
+    auto tracker = std::make_shared<int>(0);
+    {
+        Text text;
+        type(text, "ab");
+        text.insert<Marker>(tracker);
+        type(text, "cd");
+        text.move_cursor(2);
+
+        Text copy = text;
+        CHECK(tracker.use_count() == 3);
+        CHECK(to_string(copy) == "ab#cd");
+        CHECK(copy.cursor() == 2);
+
+        Text moved = std::move(copy);
+        CHECK(to_string(moved) == "ab#cd");
+        CHECK(copy.empty());
+        CHECK(tracker.use_count() == 3);
+
+        moved = text;
+        CHECK(tracker.use_count() == 3);
+
+        text.insert<Locked>();
+        CHECK_FALSE(text.is_copyable());
+        auto copy_text = [&] { Text failed = text; };
+        CHECK_THROWS_AS(copy_text(), std::logic_error);
+        CHECK_THROWS_AS(moved = text, std::logic_error);
+    }
+    CHECK(tracker.use_count() == 1);
+}
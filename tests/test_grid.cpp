@@ -0,0 +1,211 @@
+// Copyright 2025 Dr. Matthias Hölzl
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+#include "../include/inline_poly_grid.h"
+
+struct Cell
+{
+    virtual ~Cell()              = default;
+    virtual int  heat() const    = 0;
+    virtual bool solid() const
+    {
+        return false;
+    }
+};
+
+struct Air : Cell
+{
+    int temperature;
+    explicit Air(int t = 0) : temperature(t) {}
+    int heat() const override
+    {
+        return temperature;
+    }
+};
+
+struct Wall : Cell
+{
+    std::shared_ptr<int> tracker;
+    explicit Wall(std::shared_ptr<int> t = {}) : tracker(std::move(t)) {}
+    int heat() const override
+    {
+        return 0;
+    }
+    bool solid() const override
+    {
+        return true;
+    }
+};
+
+struct Lava : Cell
+{
+    std::unique_ptr<int> level = std::make_unique<int>(100);
+    int                  heat() const override
+    {
+        return *level;
+    }
+};
+
+using Map = inline_poly::grid<Cell, 10, 6, 48, 8, 4>;
+
+static Map make_map()
+{
+    Map map;
+    for (std::size_t y = 0; y < Map::height(); ++y)
+    {
+        for (std::size_t x = 0; x < Map::width(); ++x)
+        {
+            map.emplace<Air>(x, y, static_cast<int>(10 * y + x));
+        }
+    }
+    return map;
+}
+
+TEST_CASE("grid - Morton layout inside tiles")
+{
+    // 10 x 6 cells in 4 x 4 tiles: 3 x 2 tiles
+    CHECK(Map::slot_count == 96);
+    CHECK(Map::index_of(0, 0) == 0);
+    CHECK(Map::index_of(1, 0) == 1);
+    CHECK(Map::index_of(0, 1) == 2);
+    CHECK(Map::index_of(1, 1) == 3);
+    CHECK(Map::index_of(2, 0) == 4);
+    CHECK(Map::index_of(3, 3) == 15);
+    CHECK(Map::index_of(4, 0) == 16);
+    CHECK(Map::index_of(0, 4) == 48);
+
+    // Every cell has a unique slot and round-trips
+    std::set<std::size_t> seen;
+    for (std::size_t y = 0; y < Map::height(); ++y)
+    {
+        for (std::size_t x = 0; x < Map::width(); ++x)
+        {
+            const auto index = Map::index_of(x, y);
+            CHECK(index < Map::slot_count);
+            CHECK(seen.insert(index).second);
+            CHECK(Map::position_of(index) == std::pair{x, y});
+        }
+    }
+}
+
+TEST_CASE("grid - Access and neighbors")
+{
+    Map map = make_map();
+    REQUIRE(map.at(3, 2) != nullptr);
+    CHECK(map.at(3, 2)->heat() == 23);
+    CHECK(map(9, 5)->heat() == 59);
+    CHECK_THROWS_AS((void)map.at(10, 0), std::out_of_range);
+
+    // Vertically adjacent cells of a 2 x 2 block are two slots apart
+    auto* above = reinterpret_cast<std::byte*>(map(2, 2));
+    auto* below = reinterpret_cast<std::byte*>(map(2, 3));
+    CHECK(below - above == 2 * 48);
+
+    int sum   = 0;
+    int count = 0;
+    map.for_each_neighbor(0, 0,
+                          [&](Cell& cell, std::size_t, std::size_t)
+                          {
+                              sum += cell.heat();
+                              ++count;
+                          });
+    CHECK(count == 3);
+    CHECK(sum == 1 + 10 + 11);
+
+    std::vector<std::pair<std::size_t, std::size_t>> cross;
+    auto record = [&](Cell&, std::size_t x, std::size_t y)
+    { cross.emplace_back(x, y); };
+    map.for_each_neighbor(4, 3, record, inline_poly::neighborhood::von_neumann);
+    CHECK(cross.size() == 4);
+
+    map.emplace<Wall>(5, 3);
+    int walls = 0;
+    map.for_each_neighbor(4, 3,
+                          [&](Cell& cell, std::size_t, std::size_t)
+                          { walls += cell.solid(); });
+    CHECK(walls == 1);
+}
+
+TEST_CASE("grid - Regions and traversal")
+{
+    Map map = make_map();
+
+    std::size_t visited = 0;
+    map.for_each([&](Cell&, std::size_t, std::size_t) { ++visited; });
+    CHECK(visited == 60);
+
+    auto view = map.region(3, 1, 3, 4);
+    CHECK(view.count() == 12);
+    int sum = 0;
+    view.each(
+        [&](Cell& cell, std::size_t x, std::size_t y)
+        {
+            CHECK(view.contains(x, y));
+            sum += cell.heat();
+        });
+    // Rows 1..4, columns 3..5
+    CHECK(sum == (13 + 14 + 15) + (23 + 24 + 25) + (33 + 34 + 35) +
+                     (43 + 44 + 45));
+
+    // Regions are clipped to the grid
+    auto corner = map.region(8, 4, 10, 10);
+    CHECK(corner.width() == 2);
+    CHECK(corner.height() == 2);
+    CHECK(corner.count() == 4);
+
+    const Map& constant = map;
+    CHECK(constant.region(0, 0, 2, 2).count() == 4);
+}
+
+TEST_CASE("grid - Filling a full-size tile map")
+{
+    using TileMap = inline_poly::grid<Cell, 256, 256, 16, 8, 8>;
+    auto map      = std::make_unique<TileMap>();
+
+    // Each write is O(1), so this stays fast even for 65536 cells
+    for (std::size_t y = 0; y < TileMap::height(); ++y)
+    {
+        for (std::size_t x = 0; x < TileMap::width(); ++x)
+        {
+            map->emplace<Air>(x, y, static_cast<int>(x + y));
+        }
+    }
+    CHECK(map->cells().occupied_count() == 256 * 256);
+    CHECK(map->at(255, 255)->heat() == 510);
+    CHECK(map->is_copyable());
+
+    // Overwriting cells keeps the capabilities exact
+    map->emplace<Lava>(3, 4);
+    CHECK_FALSE(map->is_copyable());
+    map->emplace<Air>(3, 4, 1);
+    CHECK(map->is_copyable());
+    CHECK(map->at(3, 4)->heat() == 1);
+}
+
+TEST_CASE("grid - Copy, move and cleanup")
+{
+    auto tracker = std::make_shared<int>(0);
+    {
+        Map map;
+        map.emplace<Wall>(1, 1, tracker);
+        map.emplace<Air>(2, 1, 7);
+
+        Map copy = map;
+        CHECK(tracker.use_count() == 3);
+        CHECK(copy.at(2, 1)->heat() == 7);
+
+        Map moved = std::move(copy);
+        CHECK(moved.at(1, 1)->solid());
+
+        map.emplace<Lava>(0, 0);
+        CHECK_FALSE(map.is_copyable());
+        auto copy_map = [&] { Map failed = map; };
+        CHECK_THROWS_AS(copy_map(), std::logic_error);
+    }
+    CHECK(tracker.use_count() == 1);
+}
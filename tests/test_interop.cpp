@@ -0,0 +1,176 @@
+// Copyright 2025 Dr. Matthias Hölzl
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../include/inline_poly_interop.h"
+#include "../include/inline_poly_multi_vector.h"
+
+struct Shape
+{
+    virtual ~Shape()                 = default;
+    virtual double      area() const = 0;
+    virtual std::string name() const = 0;
+};
+
+struct Circle : Shape
+{
+    double r;
+    explicit Circle(double radius) : r(radius) {}
+    double area() const override
+    {
+        return 3.0 * r * r;
+    }
+    std::string name() const override
+    {
+        return "circle";
+    }
+};
+
+struct Label : Shape
+{
+    std::string          text;
+    std::shared_ptr<int> tracker;
+    Label(std::string t, std::shared_ptr<int> tr) :
+        text(std::move(t)), tracker(std::move(tr))
+    {}
+    double area() const override
+    {
+        return static_cast<double>(text.size());
+    }
+    std::string name() const override
+    {
+        return "label " + text;
+    }
+};
+
+struct Unregistered : Shape
+{
+    double area() const override
+    {
+        return 0.0;
+    }
+    std::string name() const override
+    {
+        return "unregistered";
+    }
+};
+
+using Shapes = inline_poly::type_list<Circle, Label>;
+using Legacy = std::vector<std::unique_ptr<Shape>>;
+using Vec    = inline_poly::vector<Shape, 8, 96>;
+
+static Legacy make_legacy(const std::shared_ptr<int>& tracker)
+{
+    Legacy legacy;
+    legacy.push_back(std::make_unique<Circle>(1.0));
+    legacy.push_back(std::make_unique<Label>("long enough to allocate text",
+                                             tracker));
+    legacy.push_back(std::make_unique<Circle>(2.0));
+    return legacy;
+}
+
+TEST_CASE("interop - Adopt and export a poly_vector")
+{
+    auto   tracker = std::make_shared<int>(0);
+    Legacy legacy  = make_legacy(tracker);
+    Vec    shapes;
+
+    CHECK(inline_poly::adopt_from<Shapes>(shapes, legacy) == 3);
+    CHECK(shapes.size() == 3);
+    for (const auto& ptr : legacy)
+    {
+        CHECK(ptr == nullptr);
+    }
+    CHECK(tracker.use_count() == 2);
+    CHECK(shapes[0]->area() == doctest::Approx(3.0));
+    CHECK(shapes[1]->name() == "label long enough to allocate text");
+    CHECK(shapes[2]->area() == doctest::Approx(12.0));
+
+    Legacy exported;
+    inline_poly::export_to<Shapes>(shapes, std::back_inserter(exported));
+    CHECK(shapes.empty());
+    REQUIRE(exported.size() == 3);
+    CHECK(dynamic_cast<Circle*>(exported[0].get()) != nullptr);
+    CHECK(exported[1]->name() == "label long enough to allocate text");
+    CHECK(tracker.use_count() == 2);
+
+    exported.clear();
+    CHECK(tracker.use_count() == 1);
+}
+
+TEST_CASE("interop - Errors leave both sides unchanged")
+{
+    auto   tracker = std::make_shared<int>(0);
+    Legacy legacy  = make_legacy(tracker);
+    Vec    shapes;
+
+    legacy.push_back(std::make_unique<Unregistered>());
+    CHECK_THROWS_AS(inline_poly::adopt_from<Shapes>(shapes, legacy),
+                    std::invalid_argument);
+    CHECK(shapes.empty());
+    CHECK(legacy[0] != nullptr);
+
+    legacy.back() = nullptr;
+    CHECK_THROWS_AS(inline_poly::adopt_from<Shapes>(shapes, legacy),
+                    std::invalid_argument);
+
+    legacy.pop_back();
+    for (int i = 0; i < 6; ++i)
+    {
+        shapes.emplace_back<Circle>(1.0);
+    }
+    CHECK_THROWS_AS(inline_poly::adopt_from<Shapes>(shapes, legacy),
+                    std::out_of_range);
+    CHECK(shapes.size() == 6);
+    CHECK(legacy[1] != nullptr);
+
+    shapes.emplace_back<Unregistered>();
+    Legacy exported;
+    CHECK_THROWS_AS(
+        inline_poly::export_to<Shapes>(shapes, std::back_inserter(exported)),
+        std::invalid_argument);
+    CHECK(exported.empty());
+    CHECK(shapes.size() == 7);
+}
+
+TEST_CASE("interop - Other inline containers")
+{
+    using Multi = inline_poly::multi_vector<Shape,
+                                            inline_poly::size_class<32, 4>,
+                                            inline_poly::size_class<96, 4>>;
+    auto   tracker = std::make_shared<int>(0);
+    Legacy legacy  = make_legacy(tracker);
+    Multi  shapes;
+
+    inline_poly::adopt_from<Shapes>(shapes, legacy);
+    CHECK(shapes.size() == 3);
+    CHECK(shapes.class_of(0) == 0);
+    CHECK(shapes.class_of(1) == 1);
+
+    Legacy round_trip;
+    inline_poly::export_to<Shapes>(shapes, std::back_inserter(round_trip));
+    CHECK(round_trip.size() == 3);
+    CHECK(round_trip[2]->area() == doctest::Approx(12.0));
+}
+
+TEST_CASE("interop - Export skips empty slots")
+{
+    using Arr      = inline_poly::array<Shape, 4, 96>;
+    auto   tracker = std::make_shared<int>(0);
+    Arr    shapes;
+    shapes.emplace<Circle>(1, 1.0);
+    shapes.emplace<Label>(3, "last", tracker);
+
+    Legacy exported;
+    inline_poly::export_to<Shapes>(shapes, std::back_inserter(exported));
+    REQUIRE(exported.size() == 2);
+    CHECK(exported[0]->area() == doctest::Approx(3.0));
+    CHECK(exported[1]->name() == "label last");
+    CHECK(shapes[1] == nullptr);
+    CHECK(shapes[3] == nullptr);
+    CHECK(tracker.use_count() == 2);
+}
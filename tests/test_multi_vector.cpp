@@ -0,0 +1,268 @@
+// Copyright 2025 Dr. Matthias Hölzl
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include "../include/inline_poly_multi_vector.h"
+
+struct Particle
+{
+    virtual ~Particle()      = default;
+    virtual int id() const   = 0;
+    virtual int kind() const = 0;
+};
+
+struct Spark : Particle
+{
+    int id_;
+    explicit Spark(int id) : id_(id) {}
+    int id() const override
+    {
+        return id_;
+    }
+    int kind() const override
+    {
+        return 0;
+    }
+};
+
+struct Smoke : Particle
+{
+    int         id_;
+    double      density[12]{};
+    std::string label;
+    Smoke(int id, std::string l) : id_(id), label(std::move(l)) {}
+    int id() const override
+    {
+        return id_;
+    }
+    int kind() const override
+    {
+        return 1;
+    }
+};
+
+// Copying throws once the shared budget is used up
+struct Fragile : Particle
+{
+    int* budget;
+    explicit Fragile(int* b) : budget(b) {}
+    Fragile(const Fragile& other) : budget(other.budget)
+    {
+        if ((*budget)-- == 0)
+        {
+            throw std::runtime_error("Fragile copy failed");
+        }
+    }
+    Fragile& operator=(const Fragile&) = default;
+    int id() const override
+    {
+        return -1;
+    }
+    int kind() const override
+    {
+        return 3;
+    }
+};
+
+struct Emitter : Particle
+{
+    int                  id_;
+    std::unique_ptr<int> state;
+    explicit Emitter(int id) : id_(id), state(std::make_unique<int>(id)) {}
+    int id() const override
+    {
+        return id_;
+    }
+    int kind() const override
+    {
+        return 2;
+    }
+};
+
+constexpr std::size_t SmallSlot = 16;
+constexpr std::size_t LargeSlot = 160;
+
+using SmallClass = inline_poly::size_class<SmallSlot, 8, 8>;
+using LargeClass = inline_poly::size_class<LargeSlot, 2, 8>;
+using Particles  = inline_poly::multi_vector<Particle, SmallClass, LargeClass>;
+
+static_assert(sizeof(Spark) <= SmallSlot);
+static_assert(sizeof(Smoke) > SmallSlot && sizeof(Smoke) <= LargeSlot);
+static_assert(sizeof(Fragile) <= SmallSlot);
+
+TEST_CASE("multi_vector - Types are assigned to the smallest fitting class")
+{
+    CHECK(Particles::class_for<Spark> == 0);
+    CHECK(Particles::class_for<Smoke> == 1);
+    CHECK(Particles::capacity() == 10);
+    CHECK(Particles::storage_bytes() == 8 * SmallSlot + 2 * LargeSlot);
+}
+
+TEST_CASE("multi_vector - Insertion order is preserved across pools")
+{
+    Particles particles;
+    particles.emplace_back<Spark>(1);
+    particles.emplace_back<Smoke>(2, "a");
+    particles.emplace_back<Spark>(3);
+
+    REQUIRE(particles.size() == 3);
+    CHECK(particles[0]->id() == 1);
+    CHECK(particles[1]->id() == 2);
+    CHECK(particles[2]->id() == 3);
+    CHECK(particles.class_of(0) == 0);
+    CHECK(particles.class_of(1) == 1);
+    CHECK(particles.class_size(0) == 2);
+    CHECK(particles.class_size(1) == 1);
+
+    int expected = 1;
+    for (Particle* p : particles)
+    {
+        CHECK(p->id() == expected++);
+    }
+
+    SUBCASE("emplace in the middle")
+    {
+        auto it = particles.emplace<Smoke>(particles.begin() + 1, 10, "mid");
+        CHECK((*it)->id() == 10);
+        CHECK(particles.size() == 4);
+        CHECK(particles[0]->id() == 1);
+        CHECK(particles[1]->id() == 10);
+        CHECK(particles[2]->id() == 2);
+        CHECK(particles[3]->id() == 3);
+    }
+
+    SUBCASE("erase frees the pool slot without moving objects")
+    {
+        Particle* last = particles[2];
+        particles.erase(particles.begin());
+        CHECK(particles.size() == 2);
+        CHECK(particles[0]->id() == 2);
+        CHECK(particles[1] == last);
+        CHECK(particles.class_size(0) == 1);
+    }
+
+    SUBCASE("pop_back and clear")
+    {
+        particles.pop_back();
+        CHECK(particles.size() == 2);
+        particles.clear();
+        CHECK(particles.empty());
+        CHECK(particles.class_size(0) == 0);
+        CHECK(particles.class_size(1) == 0);
+    }
+}
+
+TEST_CASE("multi_vector - Full class overflows into a larger class")
+{
+    Particles particles;
+    for (int i = 0; i < 9; ++i)
+    {
+        particles.emplace_back<Spark>(i);
+    }
+    CHECK(particles.class_size(0) == 8);
+    CHECK(particles.class_size(1) == 1);
+    CHECK(particles.class_of(8) == 1);
+
+    particles.emplace_back<Spark>(9);
+    CHECK(particles.size() == 10);
+    CHECK_THROWS_AS(particles.emplace_back<Spark>(10), std::out_of_range);
+
+    // Released slots are reused
+    particles.erase(particles.begin() + 3);
+    particles.emplace_back<Spark>(11);
+    CHECK(particles.class_of(9) == 0);
+}
+
+TEST_CASE("multi_vector - Large class exhaustion throws")
+{
+    Particles particles;
+    particles.emplace_back<Smoke>(1, "a");
+    particles.emplace_back<Smoke>(2, "b");
+    CHECK_THROWS_AS(particles.emplace_back<Smoke>(3, "c"), std::out_of_range);
+    CHECK(particles.size() == 2);
+}
+
+TEST_CASE("multi_vector - Copy and move")
+{
+    Particles particles;
+    particles.emplace_back<Spark>(1);
+    particles.emplace_back<Smoke>(2, "copied");
+
+    SUBCASE("copy duplicates objects into the same classes")
+    {
+        Particles copy = particles;
+        REQUIRE(copy.size() == 2);
+        CHECK(copy[0] != particles[0]);
+        CHECK(copy[1]->id() == 2);
+        CHECK(static_cast<Smoke*>(copy[1])->label == "copied");
+        CHECK(copy.class_of(1) == 1);
+
+        copy.emplace_back<Spark>(3);
+        CHECK(copy.class_size(0) == 2);
+    }
+
+    SUBCASE("move leaves the source empty")
+    {
+        Particles moved = std::move(particles);
+        CHECK(moved.size() == 2);
+        CHECK(static_cast<Smoke*>(moved[1])->label == "copied");
+        CHECK(particles.empty());
+        CHECK(particles.class_size(1) == 0);
+    }
+
+    SUBCASE("move-only contents block copying")
+    {
+        particles.emplace_back<Emitter>(3);
+        CHECK_FALSE(particles.is_copyable());
+        CHECK(particles.is_movable());
+        CHECK_THROWS_AS(Particles copy = particles, std::logic_error);
+
+        particles.pop_back();
+        CHECK(particles.is_copyable());
+    }
+}
+
+TEST_CASE("multi_vector - A throwing copy leaves the target empty")
+{
+    int       budget = 2;
+    Particles particles;
+    particles.emplace_back<Smoke>(1, "first");
+    particles.emplace_back<Fragile>(&budget);
+    particles.emplace_back<Spark>(3);
+    particles.emplace_back<Fragile>(&budget);
+    particles.emplace_back<Fragile>(&budget);
+
+    auto copy_particles = [&] { Particles failed = particles; };
+    CHECK_THROWS_AS(copy_particles(), std::runtime_error);
+
+    budget = 1;
+    Particles target;
+    target.emplace_back<Spark>(6);
+    CHECK_THROWS_AS(target = particles, std::runtime_error);
+    CHECK(target.empty());
+    CHECK(target.class_size(0) == 0);
+    CHECK(target.class_size(1) == 0);
+
+    // Every slot is free again
+    for (std::size_t i = 0; i < Particles::class_capacity(0); ++i)
+    {
+        target.emplace_back<Spark>(static_cast<int>(i));
+    }
+    CHECK(target.class_size(0) == Particles::class_capacity(0));
+    target.clear();
+
+    budget = 3;
+    target = particles;
+    CHECK(target.size() == 5);
+    CHECK(target[4]->kind() == 3);
+}
+
+TEST_CASE("multi_vector - Uses less storage than a single worst-case slot")
+{
+    using Single = inline_poly::vector<Particle, 10, LargeSlot, 8>;
+    CHECK(Particles::storage_bytes() < 10 * LargeSlot);
+    CHECK(sizeof(Particles) < sizeof(Single));
+}
@@ -1,6 +1,11 @@
 // Copyright 2025 Dr. Matthias Hölzl
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include <doctest/doctest.h>
+
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
 #include "../include/inline_poly.h"
 
 // Test fixture base class
@@ -525,3 +530,391 @@ TEST_CASE("inline_poly::array move efficiency")
         CHECK(arr2[1]->speak() == 20);
     }
 }
+
+// Comparable elements for equality, hashing and diff
+struct Reading : Animal
+{
+    int value;
+    explicit Reading(int v) : value(v) {}
+    int speak() const override
+    {
+        return value;
+    }
+    friend bool operator==(const Reading& lhs, const Reading& rhs)
+    {
+        return lhs.value == rhs.value;
+    }
+    friend std::size_t hash_value(const Reading& reading)
+    {
+        return std::hash<int>{}(reading.value);
+    }
+};
+
+struct Flag : Animal
+{
+    bool on;
+    explicit Flag(bool o) : on(o) {}
+    int speak() const override
+    {
+        return on;
+    }
+    friend bool operator==(const Flag& lhs, const Flag& rhs)
+    {
+        return lhs.on == rhs.on;
+    }
+};
+
+template <>
+struct std::hash<Flag>
+{
+    std::size_t operator()(const Flag& flag) const noexcept
+    {
+        return flag.on ? 17 : 4;
+    }
+};
+
+TEST_CASE("inline_poly::array equality, hash and diff")
+{
+    using Readings = inline_poly::array<Animal, 4, sizeof(LargeDog)>;
+
+    SUBCASE("type operations record equality and hashing")
+    {
+        const auto& reading_ops = inline_poly::get_type_ops<Reading>();
+        CHECK(reading_ops.equal != nullptr);
+        CHECK(reading_ops.hash != nullptr);
+        CHECK(inline_poly::get_type_ops<Flag>().hash != nullptr);
+        CHECK(inline_poly::get_type_ops<Dog>().equal == nullptr);
+        CHECK(inline_poly::get_type_ops<Dog>().hash == nullptr);
+
+        // Trivially copyable types without padding compare bytewise
+        CHECK(inline_poly::get_type_ops<int>().equal != nullptr);
+        CHECK(inline_poly::get_type_ops<long>().hash != nullptr);
+    }
+
+    Readings before;
+    before.emplace<Reading>(0, 1);
+    before.emplace<Flag>(1, true);
+    before.emplace<Reading>(3, 4);
+
+    Readings after = before;
+    CHECK(after == before);
+    CHECK(after.hash() == before.hash());
+
+    SUBCASE("diff reports changed, added and removed slots")
+    {
+        after.emplace<Reading>(0, 2);
+        after.emplace<Reading>(1, 1); // Same value, different type
+        after.emplace<Reading>(2, 0);
+
+        CHECK(after != before);
+        CHECK(after.hash() != before.hash());
+
+        std::vector<std::size_t> changed;
+        diff(before, after, std::back_inserter(changed));
+        CHECK(changed == std::vector<std::size_t>{0, 1, 2});
+    }
+
+    SUBCASE("types without equality throw when compared")
+    {
+        before.emplace<Dog>(2, 1);
+        after.emplace<Dog>(2, 1);
+        CHECK_THROWS_AS((void)(before == after), std::logic_error);
+        CHECK_THROWS_AS((void)before.hash(), std::logic_error);
+
+        // Different types are decided by the ops pointers alone
+        after.emplace<Cat>(2);
+        CHECK_FALSE(before == after);
+    }
+}
+
+TEST_CASE("inline_poly::array compaction")
+{
+    using Pool = inline_poly::array<Animal, 8, sizeof(LargeDog)>;
+    Pool pool;
+    CHECK(pool.occupied_prefix() == 0);
+
+    pool.emplace<Dog>(1, 10);
+    pool.emplace<Cat>(4);
+    pool.emplace<LargeDog>(6, 60);
+    pool.emplace<Dog>(7, 70);
+    CHECK(pool.occupied_prefix() == 8);
+
+    SUBCASE("reset empties a slot and shrinks the occupied prefix")
+    {
+        pool.reset(7);
+        CHECK(pool[7] == nullptr);
+        CHECK(pool.occupied_prefix() == 7);
+        pool.reset(6);
+        CHECK(pool.occupied_prefix() == 5);
+        pool.reset(0); // Already empty
+        CHECK(pool.occupied_prefix() == 5);
+        CHECK_THROWS_AS(pool.reset(8), std::out_of_range);
+    }
+
+    SUBCASE("compact moves objects into a dense prefix")
+    {
+        pool.reset(6);
+        std::vector<std::size_t> remap;
+        CHECK(pool.compact(std::back_inserter(remap)) == 3);
+
+        const auto npos = Pool::npos;
+        CHECK(remap == std::vector<std::size_t>{npos, 0, npos, npos, 1, npos,
+                                                npos, 2});
+        CHECK(pool.occupied_prefix() == 3);
+        CHECK(pool[0]->speak() == 10);
+        CHECK(pool[1]->speak() == -1);
+        CHECK(pool[2]->speak() == 70);
+        for (std::size_t i = 3; i < pool.size(); ++i)
+        {
+            CHECK(pool[i] == nullptr);
+        }
+
+        // Iteration sees the moved objects
+        int total = 0;
+        for (Animal* animal : pool)
+        {
+            total += animal ? animal->speak() : 0;
+        }
+        CHECK(total == 79);
+
+        // Compacting a dense array is a no-op
+        CHECK(pool.compact() == 3);
+        CHECK(pool[2]->speak() == 70);
+    }
+
+    SUBCASE("copies and moves keep the occupied prefix")
+    {
+        Pool copy = pool;
+        CHECK(copy.occupied_prefix() == 8);
+        Pool moved = std::move(copy);
+        CHECK(moved.occupied_prefix() == 8);
+        CHECK(copy.occupied_prefix() == 0);
+        pool.clear();
+        CHECK(pool.occupied_prefix() == 0);
+    }
+}
+
+TEST_CASE("inline_poly::array pool allocation")
+{
+    // More than one bitmap word
+    using Pool = inline_poly::array<Animal, 130, sizeof(LargeDog)>;
+    Pool pool;
+
+    for (std::size_t i = 0; i < 130; ++i)
+    {
+        auto [index, dog] = pool.emplace_any<Dog>(static_cast<int>(i));
+        CHECK(index == i);
+        CHECK(dog->speak() == static_cast<int>(i));
+    }
+    CHECK(pool.occupied_count() == 130);
+    CHECK(pool.is_copyable());
+    CHECK_THROWS_AS(pool.emplace_any<Cat>(), std::out_of_range);
+
+    SUBCASE("released slots are reused lowest first")
+    {
+        pool.release(100);
+        pool.release(5);
+        pool.release(129);
+        CHECK(pool.occupied_count() == 127);
+        CHECK(pool[5] == nullptr);
+        CHECK(pool.occupied_prefix() == 129);
+
+        CHECK(pool.emplace_any<Cat>().first == 5);
+        CHECK(pool.emplace_any<Cat>().first == 100);
+        CHECK(pool.emplace_any<Cat>().first == 129);
+        CHECK(pool[100]->speak() == -1);
+        CHECK_THROWS_AS(pool.emplace_any<Cat>(), std::out_of_range);
+    }
+
+    SUBCASE("release rejects empty slots")
+    {
+        pool.release(7);
+        CHECK_THROWS_AS(pool.release(7), std::logic_error);
+        CHECK_THROWS_AS(pool.release(130), std::out_of_range);
+    }
+
+    SUBCASE("other modifiers keep the bitmap in sync")
+    {
+        pool.reset(3);
+        pool.emplace<Cat>(3);
+        pool.reset(64);
+        CHECK(pool.emplace_any<Dog>().first == 64);
+
+        for (std::size_t i = 0; i < 130; i += 2)
+        {
+            pool.release(i);
+        }
+        CHECK(pool.compact() == 65);
+        CHECK(pool.emplace_any<Cat>().first == 65);
+
+        Pool copy = pool;
+        CHECK(copy.emplace_any<Cat>().first == 66);
+        pool.clear();
+        CHECK(pool.occupied_count() == 0);
+        CHECK(pool.emplace_any<Cat>().first == 0);
+    }
+
+    SUBCASE("capabilities follow the stored types")
+    {
+        struct Pinned : Animal
+        {
+            Pinned()              = default;
+            Pinned(const Pinned&) = delete;
+            Pinned(Pinned&&)      = delete;
+            int speak() const override
+            {
+                return 0;
+            }
+        };
+
+        pool.release(0);
+        pool.emplace_any<Pinned>();
+        CHECK_FALSE(pool.is_copyable());
+        CHECK_FALSE(pool.is_movable());
+        pool.release(0);
+        CHECK(pool.is_copyable());
+        CHECK(pool.is_movable());
+    }
+}
+
+struct indexed_animals : inline_poly::default_policy
+{
+    using indexed_types = inline_poly::type_list<Dog, Cat>;
+};
+
+TEST_CASE("inline_poly::array per-type index")
+{
+    using Pool = inline_poly::array<Animal, 100, sizeof(LargeDog),
+                                    alignof(LargeDog), indexed_animals>;
+    Pool pool;
+    pool.emplace<Dog>(3, 3);
+    pool.emplace<Cat>(5);
+    pool.emplace<Dog>(70, 70);
+    pool.emplace_any<LargeDog>(1);
+
+    const auto dogs = pool.indices_of<Dog>();
+    CHECK(std::vector<std::size_t>(dogs.begin(), dogs.end()) ==
+          std::vector<std::size_t>{3, 70});
+
+    int barks = 0;
+    pool.for_each<Dog>([&](Dog& dog) { barks += dog.speak(); });
+    CHECK(barks == 73);
+
+    pool.emplace<Cat>(3); // Replaces a Dog
+    pool.release(5);
+    CHECK(pool.indices_of<Dog>().size() == 1);
+    CHECK(*pool.indices_of<Cat>().begin() == 3);
+
+    pool.compact();
+    CHECK(*pool.indices_of<Cat>().begin() == 1);
+    CHECK(*pool.indices_of<Dog>().begin() == 2);
+
+    pool.clear();
+    CHECK(pool.indices_of<Dog>().empty());
+}
+
+TEST_CASE("inline_poly::array incremental snapshot")
+{
+    using State = inline_poly::array<Animal, 100, sizeof(LargeDog)>;
+    State state;
+    for (std::size_t i = 0; i < 100; i += 2)
+    {
+        state.emplace<Dog>(i, static_cast<int>(i));
+    }
+
+    SUBCASE("copies a bounded number of slots per step")
+    {
+        auto snapshot = state.begin_snapshot();
+        CHECK_FALSE(snapshot.step(30));
+        CHECK(snapshot.progress() == 30);
+        CHECK_THROWS_AS((void)snapshot.take(), std::logic_error);
+        CHECK_FALSE(snapshot.step(30));
+        CHECK_FALSE(snapshot.step(30));
+        CHECK(snapshot.step(30));
+
+        const State copy = snapshot.take();
+        CHECK(copy.is_copyable());
+        for (std::size_t i = 0; i < 100; ++i)
+        {
+            if (i % 2 == 0)
+            {
+                REQUIRE(copy[i] != nullptr);
+                CHECK(copy[i]->speak() == static_cast<int>(i));
+                CHECK(copy[i] != state[i]);
+            }
+            else
+            {
+                CHECK(copy[i] == nullptr);
+            }
+        }
+    }
+
+    SUBCASE("slots changed after they were copied are copied again")
+    {
+        auto snapshot = state.begin_snapshot();
+        snapshot.step(50);
+
+        state.emplace<Cat>(10);                  // Replaced
+        state.reset(20);                         // Emptied
+        state.emplace<Dog>(21, 21);              // Filled
+        state.emplace<Dog>(60, 600);             // Not copied yet
+        static_cast<Dog*>(state[30])->barkCount = 300;
+        state.touch(30);                         // Modified in place
+
+        CHECK_FALSE(snapshot.step(50));          // First pass ends
+        CHECK_FALSE(snapshot.done());
+        CHECK(snapshot.step(4));                 // Four dirty slots
+
+        const State copy = snapshot.take();
+        CHECK(copy[10]->speak() == -1);
+        CHECK(copy[20] == nullptr);
+        CHECK(copy[21]->speak() == 21);
+        CHECK(copy[30]->speak() == 300);
+        CHECK(copy[60]->speak() == 600);
+    }
+
+    SUBCASE("a throwing copy leaves the slot due")
+    {
+        struct Fragile : Animal
+        {
+            int* budget;
+            explicit Fragile(int* b) : budget(b) {}
+            Fragile(const Fragile& other) : Animal(other), budget(other.budget)
+            {
+                if ((*budget)-- == 0)
+                {
+                    throw std::runtime_error("copy failed");
+                }
+            }
+            Fragile(Fragile&&) noexcept = default;
+            int speak() const override
+            {
+                return 7;
+            }
+        };
+        int budget = 1;
+        state.emplace<Fragile>(3, &budget);
+
+        auto snapshot = state.begin_snapshot();
+        CHECK(snapshot.step(100));
+        state.touch(3);
+        CHECK_THROWS_AS(snapshot.step(10), std::runtime_error);
+        CHECK_FALSE(snapshot.done());
+
+        budget = 1;
+        CHECK(snapshot.step(10));
+        const State copy = snapshot.take();
+        CHECK(copy[3]->speak() == 7);
+        CHECK_THROWS_AS(snapshot.step(1), std::logic_error);
+    }
+
+    SUBCASE("only one snapshot at a time")
+    {
+        {
+            auto snapshot = state.begin_snapshot();
+            CHECK_THROWS_AS((void)state.begin_snapshot(), std::logic_error);
+        }
+        auto again = state.begin_snapshot();
+        CHECK(again.step(1000));
+    }
+}
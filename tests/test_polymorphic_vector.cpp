@@ -2,6 +2,7 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include <doctest/doctest.h>
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <vector>
@@ -1500,3 +1501,643 @@ TEST_CASE("inline_poly::vector - pop_back() properly destroys elements")
     // All elements destroyed when container goes out of scope
     CHECK(g_immovable_destructed == 3);
 }
+
+// --- Equality, Hash and Diff ---
+
+class Tagged : public Animal
+{
+public:
+    Tagged(int id, std::string tag) : Animal(id), tag_(std::move(tag)) {}
+    std::string speak() const override
+    {
+        return tag_;
+    }
+    friend bool operator==(const Tagged& lhs, const Tagged& rhs)
+    {
+        return lhs.id() == rhs.id() && lhs.tag_ == rhs.tag_;
+    }
+    friend std::size_t hash_value(const Tagged& tagged)
+    {
+        return std::hash<std::string>{}(tagged.tag_) ^
+               static_cast<std::size_t>(tagged.id());
+    }
+
+private:
+    std::string tag_;
+};
+
+TEST_CASE("inline_poly::vector - Equality, hash and diff")
+{
+    using TaggedVector = inline_poly::vector<Animal, 8, sizeof(Tagged)>;
+
+    TaggedVector a;
+    a.emplace_back<Tagged>(1, "one");
+    a.emplace_back<Tagged>(2, "two");
+    a.emplace_back<Tagged>(3, "three");
+
+    TaggedVector b = a;
+    CHECK(a == b);
+    CHECK(a.hash() == b.hash());
+
+    b.erase(b.begin() + 1);
+    b.emplace<Tagged>(b.begin() + 1, 2, "TWO");
+    CHECK(b.size() == 3);
+    CHECK(a != b);
+
+    std::vector<std::size_t> changed;
+    diff(a, b, std::back_inserter(changed));
+    CHECK(changed == std::vector<std::size_t>{1});
+
+    b.emplace_back<Tagged>(4, "four");
+    changed.clear();
+    diff(a, b, std::back_inserter(changed));
+    CHECK(changed == std::vector<std::size_t>{1, 3});
+    CHECK(a != b);
+
+    // Elements of types without operator== only compare by type
+    TaggedVector dogs;
+    dogs.emplace_back<Dog>(1);
+    TaggedVector cats;
+    cats.emplace_back<Cat>(1);
+    CHECK_FALSE(dogs == cats);
+    TaggedVector more_dogs = dogs;
+    CHECK_THROWS_AS((void)(dogs == more_dogs), std::logic_error);
+}
+
+TEST_CASE("inline_poly::vector - Equality and hash with empty slots")
+{
+    using TaggedVector = inline_poly::vector<Animal, 8, sizeof(Tagged)>;
+
+    TaggedVector a;
+    a.emplace_back<Tagged>(1, "one");
+    a.resize(3);
+    TaggedVector b;
+    b.emplace_back<Tagged>(1, "one");
+    b.resize(3);
+    CHECK(a == b);
+    CHECK(a.hash() == b.hash());
+
+    TaggedVector c;
+    c.emplace_back<Tagged>(1, "one");
+    c.emplace_back<Tagged>(2, "two");
+    c.resize(3);
+    CHECK(a != c);
+    std::vector<std::size_t> changed;
+    diff(a, c, std::back_inserter(changed));
+    CHECK(changed == std::vector<std::size_t>{1});
+}
+
+// --- Deferred Erase ---
+
+TEST_CASE("inline_poly::vector - erase_deferred leaves tombstones")
+{
+    TestVector vec;
+    for (int i = 0; i < 8; ++i)
+    {
+        vec.emplace_back<Dog>(i);
+    }
+    Animal* survivor = vec[5];
+
+    vec.erase_deferred(1);
+    vec.erase_deferred(4);
+    vec.erase_deferred(6);
+
+    // Nothing moved: indices and addresses of the other elements are stable
+    CHECK(vec.size() == 8);
+    CHECK(vec.erased_count() == 3);
+    CHECK(vec[5] == survivor);
+    CHECK(vec[1] == nullptr);
+    CHECK(vec.is_erased(4));
+    CHECK_FALSE(vec.is_erased(5));
+    CHECK_THROWS_AS(vec.erase_deferred(4), std::logic_error);
+    CHECK_THROWS_AS(vec.erase_deferred(8), std::out_of_range);
+
+    std::vector<int> ids;
+    for (Animal* animal : vec.live())
+    {
+        ids.push_back(animal->id());
+    }
+    CHECK(ids == std::vector<int>{0, 2, 3, 5, 7});
+    CHECK(vec.live().size() == 5);
+
+    SUBCASE("compact closes all holes in order")
+    {
+        vec.compact();
+        CHECK(vec.size() == 5);
+        CHECK(vec.erased_count() == 0);
+        CHECK(vec[3]->id() == 5);
+        CHECK(vec[4]->id() == 7);
+        vec.emplace_back<Cat>(9);
+        CHECK(vec[5]->id() == 9);
+        CHECK_FALSE(vec.is_erased(5));
+    }
+
+    SUBCASE("tombstones move with shifted elements")
+    {
+        vec.emplace<Cat>(vec.begin(), 42);
+        CHECK(vec.is_erased(2));
+        CHECK(vec.is_erased(5));
+        CHECK_FALSE(vec.is_erased(1));
+
+        vec.erase(vec.begin() + 2);
+        CHECK(vec.erased_count() == 2);
+        CHECK(vec.is_erased(4));
+
+        vec.pop_back();
+        vec.pop_back();
+        CHECK(vec.erased_count() == 1);
+        CHECK(vec.size() == 6);
+    }
+
+    SUBCASE("copies and moves keep tombstones")
+    {
+        TestVector copy = vec;
+        CHECK(copy.erased_count() == 3);
+        CHECK(copy[1] == nullptr);
+        CHECK(copy[2]->id() == 2);
+
+        TestVector moved = std::move(copy);
+        CHECK(moved.is_erased(6));
+        CHECK(copy.erased_count() == 0);
+
+        moved.clear();
+        CHECK(moved.erased_count() == 0);
+        CHECK_FALSE(moved.is_erased(6));
+    }
+}
+
+TEST_CASE("inline_poly::vector - erase_deferred updates capabilities")
+{
+    WidgetVector vec;
+    vec.emplace_back<Label>("Copyable");
+    vec.emplace_back<Canvas>(50);
+    vec.emplace_back<Canvas>(60);
+    vec.emplace_back<Label>("Also copyable");
+    CHECK_FALSE(vec.is_copyable());
+
+    vec.erase_deferred(0);
+    CHECK_FALSE(vec.is_copyable());
+    vec.erase_deferred(1);
+    CHECK_FALSE(vec.is_copyable()); // One Canvas is left
+    vec.erase_deferred(2);
+    CHECK(vec.is_copyable());
+    CHECK(vec.is_movable());
+
+    vec.erase_deferred(3);
+    CHECK(vec.live().size() == 0);
+    CHECK(vec.is_copyable());
+}
+
+struct eager_compaction : inline_poly::default_policy
+{
+    static constexpr double tombstone_compaction_ratio = 0.5;
+};
+
+TEST_CASE("inline_poly::vector - erase_deferred compacts at the policy ratio")
+{
+    inline_poly::vector<Animal, 130, TestSlotSize, alignof(Animal),
+                        eager_compaction>
+        vec;
+    for (int i = 0; i < 130; ++i)
+    {
+        vec.emplace_back<Dog>(i);
+    }
+    // Tombstones in every bitmap word
+    for (std::size_t i = 0; i < 64; ++i)
+    {
+        vec.erase_deferred(2 * i);
+    }
+    CHECK(vec.size() == 130);
+    CHECK(vec.erased_count() == 64);
+
+    vec.erase_deferred(128);
+    CHECK(vec.size() == 65);
+    CHECK(vec.erased_count() == 0);
+    for (std::size_t i = 0; i < 64; ++i)
+    {
+        CHECK(vec[i]->id() == static_cast<int>(2 * i + 1));
+    }
+    CHECK(vec[64]->id() == 129);
+}
+
+struct indexed_animals : inline_poly::default_policy
+{
+    using indexed_types = inline_poly::type_list<Dog, Cat>;
+};
+
+TEST_CASE("inline_poly::vector - per-type index")
+{
+    using Zoo = inline_poly::vector<Animal, 100, TestSlotSize, alignof(Animal),
+                                    indexed_animals>;
+    using Indices = std::vector<std::size_t>;
+
+    const auto indices = [](const auto& view)
+    { return Indices(view.begin(), view.end()); };
+
+    Zoo zoo;
+    for (int i = 0; i < 90; ++i)
+    {
+        if (i % 3 == 0)
+        {
+            zoo.emplace_back<Cat>(i);
+        }
+        else
+        {
+            zoo.emplace_back<Dog>(i);
+        }
+    }
+    zoo.emplace_back<BigDog>(90, 40.0); // Not indexed: exact types only
+
+    CHECK(zoo.indices_of<Cat>().size() == 30);
+    CHECK(zoo.indices_of<Dog>().size() == 60);
+    CHECK(indices(zoo.indices_of<Cat>())[29] == 87);
+
+    int cat_ids = 0;
+    zoo.for_each<Cat>([&](Cat& cat) { cat_ids += cat.id(); });
+    CHECK(cat_ids == 29 * 30 / 2 * 3);
+
+    SUBCASE("shifts keep the index in step")
+    {
+        zoo.erase(zoo.begin());
+        zoo.emplace<Cat>(zoo.begin() + 1, 100);
+        for (const std::size_t i : zoo.indices_of<Cat>())
+        {
+            CHECK(zoo[i]->speak() == "Meow");
+        }
+        CHECK(indices(zoo.indices_of<Cat>())[0] == 1);
+        CHECK(indices(zoo.indices_of<Dog>())[0] == 0);
+        CHECK(zoo.indices_of<Cat>().size() == 30);
+    }
+
+    SUBCASE("erasure, compaction, copies and clear")
+    {
+        zoo.erase_deferred(0);
+        zoo.pop_back();
+        CHECK(zoo.indices_of<Cat>().size() == 29);
+        zoo.compact();
+        CHECK(indices(zoo.indices_of<Cat>())[0] == 2);
+
+        const Zoo copy = zoo;
+        CHECK(copy.indices_of<Cat>().size() == 29);
+        std::size_t dogs = 0;
+        copy.for_each<Dog>([&](const Dog&) { ++dogs; });
+        CHECK(dogs == 60);
+
+        Zoo moved = std::move(zoo);
+        CHECK(moved.indices_of<Dog>().size() == 60);
+        CHECK(zoo.indices_of<Dog>().empty());
+
+        moved.clear();
+        CHECK(moved.indices_of<Cat>().empty());
+    }
+}
+
+TEST_CASE("inline_poly::vector - incremental clear")
+{
+    struct Tracked : Animal
+    {
+        std::shared_ptr<int> tracker;
+        Tracked(int id, std::shared_ptr<int> t) :
+            Animal(id), tracker(std::move(t))
+        {}
+        std::string speak() const override
+        {
+            return "...";
+        }
+    };
+    using Herd = inline_poly::vector<Animal, 64, TestSlotSize>;
+
+    auto tracker = std::make_shared<int>(0);
+    Herd herd;
+    for (int i = 0; i < 40; ++i)
+    {
+        herd.emplace_back<Tracked>(i, tracker);
+    }
+    CHECK(tracker.use_count() == 41);
+
+    herd.begin_incremental_clear();
+    CHECK(herd.empty());
+    CHECK(herd.begin() == herd.end());
+    CHECK(herd.pending_destruction() == 40);
+    CHECK(tracker.use_count() == 41); // Nothing destroyed yet
+
+    SUBCASE("step by element count")
+    {
+        CHECK(herd.step(15) == 25);
+        CHECK(tracker.use_count() == 26);
+        CHECK(herd.step(100) == 0);
+        CHECK(tracker.use_count() == 1);
+        CHECK(herd.step(1) == 0);
+    }
+
+    SUBCASE("step by time budget")
+    {
+        while (herd.step(std::chrono::microseconds(50)) > 0)
+        {
+        }
+        CHECK(tracker.use_count() == 1);
+    }
+
+    SUBCASE("new elements reclaim pending slots on demand")
+    {
+        herd.step(10);
+        herd.emplace_back<Dog>(100);
+        herd.emplace<Cat>(herd.begin(), 101);
+        CHECK(herd.size() == 2);
+        CHECK(herd.pending_destruction() == 30);
+
+        // Growing past reclaimed slots destroys the pending objects there
+        herd.resize(12);
+        CHECK(herd.pending_destruction() == 28);
+        CHECK(tracker.use_count() == 29);
+        herd.emplace_back<Dog>(102);
+        CHECK(tracker.use_count() == 28);
+        CHECK(herd[0]->id() == 101);
+        CHECK(herd[12]->id() == 102);
+    }
+
+    SUBCASE("a second incremental clear covers both ranges")
+    {
+        herd.step(35);
+        herd.emplace_back<Tracked>(50, tracker);
+        herd.begin_incremental_clear();
+        CHECK(herd.pending_destruction() == 40);
+        herd.step(40);
+        CHECK(tracker.use_count() == 1);
+    }
+
+    SUBCASE("clear and destruction finish pending work")
+    {
+        herd.step(5);
+        {
+            Herd other = std::move(herd);
+            CHECK(other.empty());
+        }
+        CHECK(tracker.use_count() == 36);
+        herd.clear();
+        CHECK(tracker.use_count() == 1);
+        CHECK(herd.pending_destruction() == 0);
+    }
+}
+
+TEST_CASE("inline_poly::vector - incremental clear empties the per-type index")
+{
+    using Zoo = inline_poly::vector<Animal, 16, TestSlotSize, alignof(Animal),
+                                    indexed_animals>;
+
+    Zoo zoo;
+    for (int i = 0; i < 8; ++i)
+    {
+        zoo.emplace_back<Cat>(i);
+        zoo.emplace_back<Dog>(i);
+    }
+
+    int visited = 0;
+    zoo.begin_incremental_clear();
+    CHECK(zoo.indices_of<Cat>().empty());
+    CHECK(zoo.indices_of<Dog>().empty());
+    zoo.for_each<Cat>([&](Cat&) { ++visited; });
+    CHECK(visited == 0);
+
+    zoo.step(5);
+    CHECK(zoo.indices_of<Cat>().empty());
+    zoo.for_each<Dog>([&](Dog&) { ++visited; });
+    CHECK(visited == 0);
+
+    // Reusing a pending slot indexes only the new element
+    for (int i = 0; i < 6; ++i)
+    {
+        zoo.emplace_back<Dog>(i + 1);
+    }
+    CHECK(zoo.indices_of<Cat>().empty());
+    CHECK(zoo.indices_of<Dog>().size() == 6);
+    zoo.for_each<Dog>([&](Dog& dog) { visited += dog.id(); });
+    CHECK(visited == 21);
+
+    zoo.step(100);
+    CHECK(zoo.indices_of<Dog>().size() == 6);
+}
+
+// Cat only holds plain data, so its bytes can be moved
+template <>
+struct inline_poly::is_trivially_relocatable<Cat> : std::true_type
+{};
+
+TEST_CASE("inline_poly::vector - erase_if")
+{
+    struct Pet : Animal
+    {
+        std::shared_ptr<int> tracker;
+        Pet(int id, std::shared_ptr<int> t) : Animal(id), tracker(std::move(t))
+        {}
+        std::string speak() const override
+        {
+            return "Purr";
+        }
+    };
+    using Shelter = inline_poly::vector<Animal, 64, TestSlotSize,
+                                        alignof(Animal), indexed_animals>;
+
+    auto    tracker = std::make_shared<int>(0);
+    Shelter shelter;
+    for (int i = 0; i < 40; ++i)
+    {
+        // Runs of Cats (memmove) interrupted by Pets and Dogs
+        if (i % 5 == 4)
+        {
+            shelter.emplace_back<Pet>(i, tracker);
+        }
+        else if (i % 7 == 6)
+        {
+            shelter.emplace_back<Dog>(i);
+        }
+        else
+        {
+            shelter.emplace_back<Cat>(i);
+        }
+    }
+    shelter.erase_deferred(1);
+
+    const auto odd = [](const Animal* a) { return a && a->id() % 2 == 1; };
+    CHECK(erase_if(shelter, odd) == 19); // 20 odd ids, one already erased
+    CHECK(shelter.size() == 20);
+    CHECK(shelter.erased_count() == 0);
+    CHECK(tracker.use_count() == 5); // Pets 4, 14, 24, 34
+
+    for (std::size_t i = 0; i < shelter.size(); ++i)
+    {
+        CHECK(shelter[i]->id() == static_cast<int>(2 * i));
+    }
+    CHECK(shelter[2]->speak() == "Purr");
+    CHECK(shelter[10]->speak() == "Woof"); // id 20
+    const auto dogs = shelter.indices_of<Dog>(); // ids 6 and 20
+    CHECK(std::vector<std::size_t>(dogs.begin(), dogs.end()) ==
+          std::vector<std::size_t>{3, 10});
+
+    int visited = 0;
+    for (Animal* a : shelter)
+    {
+        visited += a != nullptr;
+    }
+    CHECK(visited == 20);
+
+    SUBCASE("throwing predicate keeps the unvisited elements")
+    {
+        const auto fails_at_30 = [](const Animal* a)
+        {
+            if (a->id() == 30)
+            {
+                throw std::runtime_error("predicate failed");
+            }
+            return a->id() < 10;
+        };
+        CHECK_THROWS_AS(erase_if(shelter, fails_at_30), std::runtime_error);
+        CHECK(shelter.size() == 15);
+        CHECK(shelter[0]->id() == 10);
+        CHECK(shelter[10]->id() == 30);
+        CHECK(shelter[14]->id() == 38);
+    }
+
+    CHECK(erase_if(shelter, [](const Animal*) { return true; }) > 0);
+    CHECK(shelter.empty());
+    CHECK(tracker.use_count() == 1);
+}
+
+TEST_CASE("inline_poly::vector - range insertion")
+{
+    using Yard   = inline_poly::vector<Animal, 32, TestSlotSize>;
+    using Kennel = inline_poly::vector<Animal, 8, sizeof(BigDog)>;
+
+    const auto ids = [](const auto& vec)
+    {
+        std::vector<int> result;
+        for (const Animal* a : vec)
+        {
+            result.push_back(a ? a->id() : -1);
+        }
+        return result;
+    };
+
+    Yard yard;
+    for (int i = 0; i < 5; ++i)
+    {
+        yard.emplace_back<Dog>(i);
+    }
+
+    SUBCASE("emplace_n opens one gap")
+    {
+        auto it = yard.emplace_n<Cat>(yard.begin() + 2, 3, 9);
+        CHECK(*it == yard[2]);
+        CHECK(ids(yard) == std::vector<int>{0, 1, 9, 9, 9, 2, 3, 4});
+        CHECK(yard[4]->speak() == "Meow");
+        CHECK(yard[5]->speak() == "Woof");
+
+        yard.emplace_n<Dog>(yard.end(), 2, 7);
+        CHECK(yard.size() == 10);
+        CHECK_THROWS_AS(yard.emplace_n<Dog>(yard.begin(), 23, 0),
+                        std::out_of_range);
+        CHECK(yard.size() == 10);
+    }
+
+    SUBCASE("insert_range copies from another vector")
+    {
+        Kennel kennel;
+        kennel.emplace_back<BigDog>(20, 30.0);
+        kennel.emplace_back<Cat>(21);
+        kennel.emplace_back<Dog>(22);
+
+        yard.insert_range(yard.begin() + 1, kennel, 0, 2);
+        CHECK(ids(yard) == std::vector<int>{0, 20, 21, 1, 2, 3, 4});
+        CHECK(yard[1]->speak() == "WOOF!");
+        CHECK(yard[1] != kennel[0]);
+        CHECK(kennel.size() == 3);
+
+        // From the vector itself: the source range is read before the shift
+        yard.insert_range(yard.begin() + 2, yard, 0, 4);
+        CHECK(ids(yard) == std::vector<int>{0, 20, 0, 20, 21, 1, 21, 1, 2, 3, 4});
+
+        CHECK_THROWS_AS(yard.insert_range(yard.begin(), kennel, 2, 4),
+                        std::out_of_range);
+    }
+
+    SUBCASE("insert_range relocates from an rvalue vector")
+    {
+        Kennel kennel;
+        kennel.emplace_back<Cat>(30);
+        kennel.emplace_back<Dog>(31);
+        yard.insert_range(yard.begin(), std::move(kennel));
+        CHECK(ids(yard) == std::vector<int>{30, 31, 0, 1, 2, 3, 4});
+        CHECK(kennel.empty());
+    }
+
+    SUBCASE("insert_range keeps tombstones of the source")
+    {
+        Kennel kennel;
+        for (int i = 40; i < 44; ++i)
+        {
+            kennel.emplace_back<Dog>(i);
+        }
+        kennel.erase_deferred(1);
+        kennel.erase_deferred(3);
+
+        yard.insert_range(yard.begin() + 1, kennel, 1, 4);
+        CHECK(ids(yard) == std::vector<int>{0, -1, 42, -1, 1, 2, 3, 4});
+        CHECK(yard.erased_count() == 2);
+        CHECK(yard.is_erased(1));
+        CHECK(yard.is_erased(3));
+        CHECK(yard.live().size() == 6);
+
+        yard.insert_range(yard.begin(), std::move(kennel));
+        CHECK(yard.erased_count() == 4);
+        CHECK(yard.is_erased(1));
+        CHECK(yard.is_erased(7));
+
+        yard.compact();
+        CHECK(ids(yard) == std::vector<int>{40, 42, 0, 42, 1, 2, 3, 4});
+        CHECK(yard.erased_count() == 0);
+    }
+
+    SUBCASE("elements that do not fit are rejected up front")
+    {
+        struct Huge : Animal
+        {
+            double payload[8]{};
+            Huge() : Animal(99) {}
+            std::string speak() const override
+            {
+                return "HONK";
+            }
+        };
+        inline_poly::vector<Animal, 4, sizeof(Huge)> big;
+        big.emplace_back<Huge>();
+
+        inline_poly::vector<Animal, 8, sizeof(Dog)> small;
+        small.emplace_back<Dog>(1);
+        CHECK_THROWS_AS(small.insert_range(small.begin(), big, 0, 1),
+                        std::invalid_argument);
+        CHECK(small.size() == 1);
+    }
+
+    SUBCASE("a throwing constructor closes the rest of the gap")
+    {
+        struct Fragile : Animal
+        {
+            Fragile(int id, int* budget) : Animal(id)
+            {
+                if ((*budget)-- == 0)
+                {
+                    throw std::runtime_error("out of budget");
+                }
+            }
+            std::string speak() const override
+            {
+                return "...";
+            }
+        };
+        int budget = 2;
+        CHECK_THROWS_AS(
+            yard.emplace_n<Fragile>(yard.begin() + 1, 4, 8, &budget),
+            std::runtime_error);
+        CHECK(ids(yard) == std::vector<int>{0, 8, 8, 1, 2, 3, 4});
+    }
+}
@@ -0,0 +1,208 @@
+// Copyright 2025 Dr. Matthias Hölzl
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../include/inline_poly_scheduler.h"
+
+struct Position
+{
+};
+struct Velocity
+{
+};
+struct Health
+{
+};
+
+struct Body
+{
+    virtual ~Body() = default;
+    int steps       = 0;
+};
+
+struct Rock : Body
+{
+};
+
+TEST_CASE("scheduler - Access conflicts")
+{
+    auto reader = inline_poly::access().reads<Position>();
+    auto writer = inline_poly::access().writes<Position>();
+    auto other  = inline_poly::access().writes<Health>();
+
+    CHECK_FALSE(reader.conflicts_with(inline_poly::access().reads<Position>()));
+    CHECK(reader.conflicts_with(writer));
+    CHECK(writer.conflicts_with(reader));
+    CHECK(writer.conflicts_with(writer));
+    CHECK_FALSE(writer.conflicts_with(other));
+
+    int a = 0, b = 0;
+    CHECK(inline_poly::access().write(a).conflicts_with(
+        inline_poly::access().read(a)));
+    CHECK_FALSE(inline_poly::access().write(a).conflicts_with(
+        inline_poly::access().write(b)));
+}
+
+TEST_CASE("scheduler - Dependency graph follows registration order")
+{
+    inline_poly::work_stealing_pool pool(2);
+    inline_poly::system_scheduler   scheduler(pool);
+
+    auto move = scheduler.add_system(
+        "move", inline_poly::access().reads<Velocity>().writes<Position>(),
+        [] {});
+    auto damage = scheduler.add_system(
+        "damage", inline_poly::access().writes<Health>(), [] {});
+    auto render = scheduler.add_system(
+        "render", inline_poly::access().reads<Position, Health>(), [] {});
+    auto steer = scheduler.add_system(
+        "steer", inline_poly::access().writes<Velocity>(), [] {});
+
+    scheduler.run_frame();
+    CHECK(scheduler.dependencies(move).empty());
+    CHECK(scheduler.dependencies(damage).empty());
+    CHECK(scheduler.dependencies(render) ==
+          std::vector<inline_poly::system_scheduler::system_id>{move, damage});
+    CHECK(scheduler.dependencies(steer) ==
+          std::vector<inline_poly::system_scheduler::system_id>{move});
+    CHECK(scheduler.name(render) == std::string("render"));
+
+    SUBCASE("disabled systems are left out of the graph")
+    {
+        scheduler.set_enabled(move, false);
+        scheduler.run_frame();
+        CHECK(scheduler.dependencies(render) ==
+              std::vector<inline_poly::system_scheduler::system_id>{damage});
+        CHECK(scheduler.dependencies(steer).empty());
+    }
+
+    CHECK_THROWS_AS(scheduler.set_enabled(99, false), std::out_of_range);
+}
+
+TEST_CASE("scheduler - Conflicting systems never overlap")
+{
+    inline_poly::work_stealing_pool pool(4);
+    inline_poly::system_scheduler   scheduler(pool);
+
+    std::atomic<int> writers{0};
+    std::atomic<int> readers{0};
+    std::atomic<int> violations{0};
+    std::atomic<int> runs{0};
+
+    auto write_position = [&]
+    {
+        if (writers.fetch_add(1) != 0 || readers.load() != 0)
+        {
+            ++violations;
+        }
+        std::this_thread::yield();
+        writers.fetch_sub(1);
+        ++runs;
+    };
+    auto read_position = [&]
+    {
+        readers.fetch_add(1);
+        if (writers.load() != 0)
+        {
+            ++violations;
+        }
+        std::this_thread::yield();
+        readers.fetch_sub(1);
+        ++runs;
+    };
+
+    for (int i = 0; i < 3; ++i)
+    {
+        scheduler.add_system("w", inline_poly::access().writes<Position>(),
+                             write_position);
+        scheduler.add_system("r1", inline_poly::access().reads<Position>(),
+                             read_position);
+        scheduler.add_system("r2", inline_poly::access().reads<Position>(),
+                             read_position);
+    }
+
+    for (int frame = 0; frame < 200; ++frame)
+    {
+        scheduler.run_frame();
+    }
+    CHECK(violations.load() == 0);
+    CHECK(runs.load() == 200 * 9);
+}
+
+TEST_CASE("scheduler - Chunked parallel_for covers every index once")
+{
+    for (std::size_t workers : {0u, 3u})
+    {
+        inline_poly::work_stealing_pool pool(workers);
+        std::vector<std::atomic<int>>   hits(1000);
+
+        inline_poly::parallel_for(pool, hits.size(), 64,
+                                  [&](std::size_t begin, std::size_t end)
+                                  {
+                                      for (std::size_t i = begin; i < end; ++i)
+                                      {
+                                          ++hits[i];
+                                      }
+                                  });
+
+        bool all_once = true;
+        for (auto& h : hits)
+        {
+            all_once = all_once && h.load() == 1;
+        }
+        CHECK(all_once);
+    }
+}
+
+TEST_CASE("scheduler - Systems iterate container slots in chunks")
+{
+    inline_poly::work_stealing_pool              pool(2);
+    inline_poly::system_scheduler                scheduler(pool);
+    inline_poly::vector<Body, 256, sizeof(Rock)> bodies;
+    inline_poly::array<Body, 64, sizeof(Rock)>   sparse;
+    for (int i = 0; i < 200; ++i)
+    {
+        bodies.emplace_back<Rock>();
+    }
+    sparse.emplace<Rock>(3);
+    sparse.emplace<Rock>(40);
+
+    auto step = [](Body& b) { ++b.steps; };
+    scheduler.add_system("step", inline_poly::access().write(bodies),
+                         [&](inline_poly::system_context& ctx)
+                         { ctx.for_each(bodies, 16, step); });
+    scheduler.add_system("step sparse", inline_poly::access().write(sparse),
+                         [&](inline_poly::system_context& ctx)
+                         { ctx.for_each(sparse, 8, step); });
+
+    scheduler.run_frame();
+    scheduler.run_frame();
+
+    int total = 0;
+    for (Body* b : bodies)
+    {
+        total += b->steps;
+    }
+    CHECK(total == 400);
+    CHECK(sparse[3]->steps == 2);
+    CHECK(sparse[40]->steps == 2);
+}
+
+TEST_CASE("scheduler - Exceptions skip dependents and propagate")
+{
+    inline_poly::work_stealing_pool pool(2);
+    inline_poly::system_scheduler   scheduler(pool);
+    bool                            dependent_ran = false;
+
+    scheduler.add_system("fail", inline_poly::access().writes<Position>(),
+                         [] { throw std::runtime_error("system failed"); });
+    scheduler.add_system("after", inline_poly::access().reads<Position>(),
+                         [&] { dependent_ran = true; });
+
+    CHECK_THROWS_AS(scheduler.run_frame(), std::runtime_error);
+    CHECK_FALSE(dependent_ran);
+}
@@ -0,0 +1,153 @@
+// Copyright 2025 Dr. Matthias Hölzl
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <iterator>
+#include <ranges>
+#include <vector>
+#include "../include/inline_poly_sorted_view.h"
+
+struct Sprite
+{
+    virtual ~Sprite()          = default;
+    virtual int depth() const = 0;
+};
+
+struct Quad : Sprite
+{
+    int z;
+    explicit Quad(int depth) : z(depth) {}
+    int depth() const override
+    {
+        return z;
+    }
+};
+
+struct Text : Sprite
+{
+    int z;
+    int length;
+    Text(int depth, int len) : z(depth), length(len) {}
+    int depth() const override
+    {
+        return z;
+    }
+};
+
+using Layer = inline_poly::vector<Sprite, 256, sizeof(Text)>;
+
+static int depth_of(const Sprite& sprite)
+{
+    return sprite.depth();
+}
+
+static std::vector<int> depths(const auto& view)
+{
+    std::vector<int> result;
+    for (const Sprite* sprite : view)
+    {
+        result.push_back(sprite->depth());
+    }
+    return result;
+}
+
+TEST_CASE("sorted_view - Orders by key without moving objects")
+{
+    Layer layer;
+    layer.emplace_back<Quad>(5);
+    layer.emplace_back<Text>(1, 3);
+    layer.emplace_back<Quad>(3);
+    layer.emplace_back<Quad>(1);
+
+    const Sprite* first = layer[0];
+    inline_poly::sorted_view by_depth(layer, depth_of);
+    CHECK(by_depth.size() == 4);
+    CHECK(depths(by_depth) == std::vector<int>{1, 1, 3, 5});
+    CHECK(layer[0] == first);
+
+    // Equal keys keep container order
+    CHECK(std::ranges::equal(by_depth.indices(),
+                             std::vector<std::uint32_t>{1, 3, 2, 0}));
+    CHECK(by_depth.key_at(2) == 3);
+
+    // Random access
+    static_assert(std::random_access_iterator<decltype(by_depth.begin())>);
+    auto it = by_depth.begin() + 2;
+    CHECK((*it)->depth() == 3);
+    CHECK(it.index() == 2);
+    CHECK(it[1]->depth() == 5);
+    CHECK(by_depth.end() - by_depth.begin() == 4);
+    CHECK(by_depth[3] == layer[0]);
+
+    // Descending order through a comparator
+    inline_poly::sorted_view<Layer, decltype(&depth_of), std::greater<>>
+        back_to_front(layer, depth_of);
+    CHECK(depths(back_to_front) == std::vector<int>{5, 3, 1, 1});
+}
+
+TEST_CASE("sorted_view - Refresh follows container and key changes")
+{
+    Layer layer;
+    for (int i = 0; i < 200; ++i)
+    {
+        layer.emplace_back<Quad>(i);
+    }
+    inline_poly::sorted_view by_depth(layer, depth_of);
+    CHECK(std::ranges::is_sorted(depths(by_depth)));
+
+    SUBCASE("small key changes are repaired without a full sort")
+    {
+        static_cast<Quad*>(layer[10])->z = 150;
+        static_cast<Quad*>(layer[190])->z = -1;
+        CHECK_FALSE(by_depth.refresh());
+        const auto sorted = depths(by_depth);
+        CHECK(std::ranges::is_sorted(sorted));
+        CHECK(sorted.front() == -1);
+        CHECK(by_depth.indices()[0] == 190);
+    }
+
+    SUBCASE("a reversed order falls back to a full sort")
+    {
+        for (int i = 0; i < 200; ++i)
+        {
+            static_cast<Quad*>(layer[static_cast<std::size_t>(i)])->z = -i;
+        }
+        CHECK(by_depth.refresh());
+        CHECK(std::ranges::is_sorted(depths(by_depth)));
+        CHECK(by_depth.indices()[0] == 199);
+    }
+
+    SUBCASE("added, erased and tombstoned elements")
+    {
+        layer.emplace_back<Text>(-5, 1);
+        layer.erase(layer.begin());
+        layer.erase_deferred(50);
+        by_depth.refresh();
+        CHECK(by_depth.size() == 199);
+        const auto sorted = depths(by_depth);
+        CHECK(std::ranges::is_sorted(sorted));
+        CHECK(sorted.front() == -5);
+        CHECK(std::ranges::find(sorted, 0) == sorted.end());
+        CHECK(std::ranges::find(sorted, 51) == sorted.end());
+    }
+}
+
+TEST_CASE("sorted_view - Arrays and const containers")
+{
+    inline_poly::array<Sprite, 8, sizeof(Text)> slots;
+    slots.emplace<Quad>(6, 2);
+    slots.emplace<Text>(1, 7, 1);
+    slots.emplace<Quad>(3, 4);
+
+    const auto& constant = slots;
+    inline_poly::sorted_view by_depth(constant, [](const Sprite& sprite)
+                                      { return sprite.depth(); });
+    CHECK(depths(by_depth) == std::vector<int>{2, 4, 7});
+    CHECK(std::ranges::equal(by_depth.indices(),
+                             std::vector<std::uint32_t>{6, 3, 1}));
+
+    slots.reset(3);
+    by_depth.refresh();
+    CHECK(depths(by_depth) == std::vector<int>{2, 7});
+}
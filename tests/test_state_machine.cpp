@@ -0,0 +1,229 @@
+// Copyright 2025 Dr. Matthias Hölzl
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../include/inline_poly_state_machine.h"
+
+struct Enemy;
+
+struct EnemyState
+{
+    virtual ~EnemyState() = default;
+    virtual const char* name() const = 0;
+    virtual void        update(Enemy& enemy) = 0;
+
+    std::vector<std::string>* log = nullptr;
+    void on_enter()
+    {
+        if (log)
+        {
+            log->push_back(std::string("enter ") + name());
+        }
+    }
+    void on_exit()
+    {
+        if (log)
+        {
+            log->push_back(std::string("exit ") + name());
+        }
+    }
+};
+
+using Machine = inline_poly::state_machine<EnemyState, 64>;
+
+struct Enemy
+{
+    int     health = 10;
+    Machine ai;
+};
+
+struct Idle : EnemyState
+{
+    explicit Idle(std::vector<std::string>* l = nullptr)
+    {
+        log = l;
+    }
+    const char* name() const override
+    {
+        return "idle";
+    }
+    void update(Enemy&) override {}
+};
+
+struct Flee : EnemyState
+{
+    explicit Flee(std::vector<std::string>* l = nullptr)
+    {
+        log = l;
+    }
+    const char* name() const override
+    {
+        return "flee";
+    }
+    void update(Enemy&) override {}
+};
+
+struct Chase : EnemyState
+{
+    int target;
+    Chase(int t, std::vector<std::string>* l = nullptr) : target(t)
+    {
+        log = l;
+    }
+    const char* name() const override
+    {
+        return "chase";
+    }
+    // Transitions requested by the running state must be deferred
+    void update(Enemy& enemy) override
+    {
+        if (enemy.health < 5)
+        {
+            enemy.ai.defer<Flee>(log);
+        }
+    }
+};
+
+struct Stunned : EnemyState
+{
+    explicit Stunned(bool fail)
+    {
+        if (fail)
+        {
+            throw std::runtime_error("stun failed");
+        }
+    }
+    const char* name() const override
+    {
+        return "stunned";
+    }
+    void update(Enemy&) override {}
+};
+
+struct Scripted : EnemyState
+{
+    std::unique_ptr<int> script = std::make_unique<int>(1);
+    const char*          name() const override
+    {
+        return "scripted";
+    }
+    void update(Enemy&) override {}
+};
+
+TEST_CASE("state_machine - Transitions replace the state in place")
+{
+    std::vector<std::string> log;
+    Machine                  machine;
+    CHECK_FALSE(machine.has_state());
+
+    machine.transition<Idle>(&log);
+    CHECK(machine.is_in<Idle>());
+    CHECK(machine.current() != nullptr);
+
+    auto& chase = machine.transition<Chase>(7, &log);
+    CHECK(chase.target == 7);
+    CHECK(machine.is_in<Chase>());
+    CHECK_FALSE(machine.is_in<Idle>());
+    CHECK(machine.get_if<Chase>() == &chase);
+    CHECK(machine.get_if<Idle>() == nullptr);
+
+    CHECK(log == std::vector<std::string>{"enter idle", "exit idle",
+                                          "enter chase"});
+
+    // The state lives inside the machine object
+    auto* bytes = reinterpret_cast<std::byte*>(machine.current());
+    CHECK(bytes >= reinterpret_cast<std::byte*>(&machine));
+    CHECK(bytes < reinterpret_cast<std::byte*>(&machine) + sizeof(machine));
+}
+
+TEST_CASE("state_machine - Deferred transitions from inside a state")
+{
+    std::vector<std::string> log;
+    Enemy                    enemy;
+    enemy.ai.transition<Chase>(1, &log);
+
+    enemy.ai.current()->update(enemy);
+    CHECK_FALSE(enemy.ai.apply_pending());
+
+    enemy.health = 2;
+    enemy.ai.current()->update(enemy);
+    CHECK(enemy.ai.is_in<Chase>());
+    REQUIRE(enemy.ai.pending() != nullptr);
+    CHECK(enemy.ai.pending()->name() == std::string("flee"));
+
+    CHECK(enemy.ai.apply_pending());
+    CHECK(enemy.ai.is_in<Flee>());
+    CHECK(enemy.ai.pending() == nullptr);
+    CHECK(log.back() == "enter flee");
+}
+
+TEST_CASE("state_machine - A throwing constructor keeps the current state")
+{
+    std::vector<std::string> log;
+    Machine                  machine;
+    machine.transition<Idle>(&log);
+    machine.defer<Flee>(&log);
+
+    CHECK_THROWS_AS(machine.transition<Stunned>(true), std::runtime_error);
+    CHECK(machine.is_in<Idle>());
+    CHECK(log == std::vector<std::string>{"enter idle"});
+
+    // The pending state shared the slot and is gone
+    CHECK(machine.pending() == nullptr);
+    CHECK_FALSE(machine.apply_pending());
+
+    machine.transition<Stunned>(false);
+    CHECK(machine.is_in<Stunned>());
+}
+
+TEST_CASE("state_machine - Cross-fade keeps both states alive")
+{
+    Machine machine;
+    machine.transition<Idle>();
+    machine.crossfade<Chase>(3);
+
+    CHECK(machine.is_in<Chase>());
+    REQUIRE(machine.previous() != nullptr);
+    CHECK(machine.previous()->name() == std::string("idle"));
+    CHECK(machine.secondary_state() == Machine::secondary_role::fading);
+
+    machine.finish_crossfade();
+    CHECK(machine.previous() == nullptr);
+    CHECK(machine.secondary_state() == Machine::secondary_role::none);
+
+    SUBCASE("a transition during the fade discards the faded state")
+    {
+        machine.crossfade<Idle>();
+        machine.transition<Flee>();
+        CHECK(machine.previous() == nullptr);
+        CHECK(machine.is_in<Flee>());
+    }
+}
+
+TEST_CASE("state_machine - Copy and move")
+{
+    Machine machine;
+    machine.transition<Chase>(42);
+
+    Machine copy = machine;
+    REQUIRE(copy.get_if<Chase>() != nullptr);
+    CHECK(copy.get_if<Chase>()->target == 42);
+    CHECK(copy.current() != machine.current());
+
+    Machine moved = std::move(copy);
+    CHECK(moved.get_if<Chase>()->target == 42);
+    CHECK_FALSE(copy.has_state());
+
+    machine.transition<Scripted>();
+    CHECK_FALSE(machine.is_copyable());
+    auto copy_machine = [&] { Machine failed = machine; };
+    CHECK_THROWS_AS(copy_machine(), std::logic_error);
+
+    Machine scripted = std::move(machine);
+    CHECK(scripted.is_in<Scripted>());
+    CHECK(*scripted.get_if<Scripted>()->script == 1);
+}
@@ -0,0 +1,157 @@
+// Copyright 2025 Dr. Matthias Hölzl
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include "../include/inline_poly_trace.h"
+
+struct Shape
+{
+    virtual ~Shape()            = default;
+    virtual double area() const = 0;
+};
+
+struct Square : Shape
+{
+    double side;
+    explicit Square(double s) : side(s) {}
+    double area() const override
+    {
+        return side * side;
+    }
+};
+
+struct traced_policy : inline_poly::default_policy
+{
+    using trace = inline_poly::chrome_trace;
+};
+
+using TracedVector =
+    inline_poly::vector<Shape, 8, sizeof(Square), alignof(Square), traced_policy>;
+using TracedArray =
+    inline_poly::array<Shape, 8, sizeof(Square), alignof(Square), traced_policy>;
+using PlainVector = inline_poly::vector<Shape, 8, sizeof(Square)>;
+
+static std::string flush_trace()
+{
+    std::ostringstream out;
+    inline_poly::trace_recorder::instance().write_chrome_json(out);
+    return out.str();
+}
+
+static bool contains(const std::string& haystack, const std::string& needle)
+{
+    return haystack.find(needle) != std::string::npos;
+}
+
+TEST_CASE("trace - Null trace policy has no footprint")
+{
+    // A span guard that compiles away: no state, no destructor and a
+    // constructor that is usable in constant expressions
+    using null_scope = inline_poly::null_trace::scope;
+    static_assert(std::is_empty_v<null_scope>);
+    static_assert(sizeof(null_scope) == 1);
+    static_assert(std::is_trivially_destructible_v<null_scope>);
+    static_assert(
+        std::is_nothrow_constructible_v<null_scope, const char*, std::size_t>);
+    static_assert((null_scope("span", 1), true));
+    CHECK(std::is_same_v<inline_poly::default_policy::trace,
+                         inline_poly::null_trace>);
+}
+
+TEST_CASE("trace - Default containers record nothing")
+{
+    inline_poly::trace_recorder::instance().discard();
+
+    PlainVector vec;
+    vec.emplace_back<Square>(1.0);
+    vec.emplace_back<Square>(2.0);
+    vec.erase(vec.begin());
+    vec.clear();
+
+    CHECK(inline_poly::trace_recorder::instance().pending() == 0);
+}
+
+TEST_CASE("trace - Vector operations emit spans")
+{
+    inline_poly::trace_recorder::instance().discard();
+
+    TracedVector vec;
+    vec.emplace_back<Square>(1.0);
+    vec.emplace_back<Square>(2.0);
+    vec.emplace_back<Square>(3.0);
+    vec.erase(vec.begin());
+    TracedVector copy  = vec;
+    TracedVector moved = std::move(copy);
+    moved.clear();
+
+    const std::string json = flush_trace();
+    CHECK(contains(json, "{\"traceEvents\":["));
+    CHECK(contains(json, "\"name\":\"poly_vector::erase\""));
+    CHECK(contains(json, "\"name\":\"poly_vector::copy\""));
+    CHECK(contains(json, "\"name\":\"poly_vector::move\""));
+    CHECK(contains(json, "\"name\":\"poly_vector::clear\""));
+    CHECK(contains(json, "\"name\":\"poly_vector::update_capabilities\""));
+    CHECK(contains(json, "\"name\":\"poly_vector::rebuild_cache\""));
+    CHECK(contains(json, "\"ph\":\"X\""));
+
+    // Flushing drains the rings
+    CHECK(inline_poly::trace_recorder::instance().pending() == 0);
+}
+
+TEST_CASE("trace - Array operations emit spans")
+{
+    inline_poly::trace_recorder::instance().discard();
+
+    TracedArray arr;
+    arr.emplace<Square>(0, 1.0);
+    arr.emplace<Square>(1, 2.0);
+    TracedArray copy = arr;
+    copy.clear();
+    arr.reset(1);
+
+    const std::string json = flush_trace();
+    CHECK(contains(json, "\"name\":\"poly_array::update_capabilities\""));
+    CHECK(contains(json, "\"name\":\"poly_array::copy\""));
+    CHECK(contains(json, "\"name\":\"poly_array::clear\""));
+}
+
+TEST_CASE("trace - User spans and per-thread buffers")
+{
+    inline_poly::trace_recorder::instance().discard();
+
+    {
+        inline_poly::chrome_trace::scope frame("frame", 1);
+    }
+    std::thread worker(
+        []
+        {
+            inline_poly::chrome_trace::scope span("worker \"job\"", 2);
+        });
+    worker.join();
+
+    const std::string json = flush_trace();
+    CHECK(contains(json, "\"name\":\"frame\""));
+    CHECK(contains(json, "\"name\":\"worker \\\"job\\\"\""));
+    CHECK(contains(json, "\"args\":{\"count\":2}"));
+}
+
+TEST_CASE("trace - Ring buffer drops events when full")
+{
+    inline_poly::trace_ring<4> ring;
+    for (int i = 0; i < 6; ++i)
+    {
+        ring.try_push({.name = "e"});
+    }
+    CHECK(ring.size() == 4);
+    CHECK(ring.dropped() == 2);
+
+    std::size_t seen = 0;
+    CHECK(ring.drain([&](const inline_poly::trace_event&) { ++seen; }) == 4);
+    CHECK(seen == 4);
+    CHECK(ring.size() == 0);
+    CHECK(ring.try_push({.name = "e"}));
+}
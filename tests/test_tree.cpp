@@ -0,0 +1,281 @@
+// Copyright 2025 Dr. Matthias Hölzl
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "../include/inline_poly_tree.h"
+
+struct SceneNode
+{
+    std::string name;
+    explicit SceneNode(std::string n) : name(std::move(n)) {}
+    virtual ~SceneNode() = default;
+    virtual bool visible() const
+    {
+        return true;
+    }
+};
+
+struct Group : SceneNode
+{
+    using SceneNode::SceneNode;
+};
+
+struct Hidden : SceneNode
+{
+    using SceneNode::SceneNode;
+    bool visible() const override
+    {
+        return false;
+    }
+};
+
+struct Mesh : SceneNode
+{
+    std::shared_ptr<int> tracker;
+    Mesh(std::string n, std::shared_ptr<int> t = {}) :
+        SceneNode(std::move(n)), tracker(std::move(t))
+    {}
+};
+
+// Base subobject at a non-zero offset inside the node
+struct Payload
+{
+    std::string data = "payload";
+    virtual ~Payload() = default;
+};
+
+struct Light : Payload, SceneNode
+{
+    std::unique_ptr<int> handle = std::make_unique<int>(3);
+    explicit Light(std::string n) : SceneNode(std::move(n)) {}
+};
+
+using Scene = inline_poly::tree<SceneNode, 16, 128>;
+
+static std::vector<std::string> names(const Scene& scene)
+{
+    std::vector<std::string> result;
+    for (const SceneNode* node : scene)
+    {
+        result.push_back(node->name);
+    }
+    return result;
+}
+
+static void check_consistent(const Scene& scene)
+{
+    for (std::size_t i = 0; i < scene.size(); ++i)
+    {
+        const std::size_t parent = scene.parent(i);
+        if (parent == Scene::npos)
+        {
+            CHECK(scene.depth(i) == 0);
+            continue;
+        }
+        CHECK(parent < i);
+        CHECK(scene.is_ancestor_or_self(parent, i));
+        CHECK(scene.depth(i) == scene.depth(parent) + 1);
+    }
+}
+
+// root
+// +- world
+// |  +- tree
+// |  +- house
+// |     +- door
+// +- ui
+static Scene make_scene()
+{
+    Scene scene;
+    auto  root  = scene.emplace_root<Group>("root");
+    auto  ui    = scene.emplace_child<Group>(root, "ui");
+    auto  world = scene.emplace_child<Group>(root, "world");
+    CHECK(world == 2);
+    // Keep "world" before "ui" by moving ui behind it
+    ui = scene.move_subtree(ui, root);
+    CHECK(ui == 2);
+    world = 1;
+    scene.emplace_child<Mesh>(world, "tree");
+    auto house = scene.emplace_child<Group>(world, "house");
+    scene.emplace_child<Mesh>(house, "door");
+    return scene;
+}
+
+TEST_CASE("tree - Nodes are stored in pre-order")
+{
+    Scene scene = make_scene();
+    CHECK(names(scene) ==
+          std::vector<std::string>{"root", "world", "tree", "house", "door",
+                                   "ui"});
+    check_consistent(scene);
+
+    CHECK(scene.subtree_size(0) == 6);
+    CHECK(scene.subtree_size(1) == 4);
+    CHECK(scene.subtree_end(1) == 5);
+    CHECK(scene.first_child(1) == 2);
+    CHECK(scene.next_sibling(2) == 3);
+    CHECK(scene.next_sibling(3) == Scene::npos);
+    CHECK(scene.next_sibling(1) == 5);
+    CHECK(scene.first_child(4) == Scene::npos);
+    CHECK(scene.child_count(0) == 2);
+    CHECK(scene.depth(4) == 3);
+
+    std::vector<std::size_t> children;
+    scene.for_each_child(1, [&](std::size_t c) { children.push_back(c); });
+    CHECK(children == std::vector<std::size_t>{2, 3});
+
+    // Contiguous slots in traversal order
+    CHECK(reinterpret_cast<std::byte*>(&scene[1]) -
+              reinterpret_cast<std::byte*>(&scene[0]) ==
+          128);
+}
+
+TEST_CASE("tree - Skipping invisible subtrees")
+{
+    Scene scene;
+    auto  root   = scene.emplace_root<Group>("root");
+    auto  hidden = scene.emplace_child<Hidden>(root, "hidden");
+    scene.emplace_child<Mesh>(hidden, "a");
+    scene.emplace_child<Mesh>(hidden, "b");
+    scene.emplace_child<Mesh>(root, "c");
+
+    std::vector<std::string> drawn;
+    for (std::size_t i = 0; i < scene.size();)
+    {
+        if (!scene[i].visible())
+        {
+            i = scene.subtree_end(i);
+            continue;
+        }
+        drawn.push_back(scene[i].name);
+        ++i;
+    }
+    CHECK(drawn == std::vector<std::string>{"root", "c"});
+}
+
+TEST_CASE("tree - Erasing a subtree")
+{
+    auto  tracker = std::make_shared<int>(0);
+    Scene scene   = make_scene();
+    scene.emplace_child<Mesh>(3, "window", tracker);
+    CHECK(tracker.use_count() == 2);
+    CHECK(names(scene) ==
+          std::vector<std::string>{"root", "world", "tree", "house", "door",
+                                   "window", "ui"});
+
+    scene.erase(3);
+    CHECK(tracker.use_count() == 1);
+    CHECK(names(scene) ==
+          std::vector<std::string>{"root", "world", "tree", "ui"});
+    CHECK(scene.subtree_size(0) == 4);
+    CHECK(scene.parent(3) == 0);
+    check_consistent(scene);
+
+    CHECK_THROWS_AS(scene.erase(4), std::out_of_range);
+}
+
+TEST_CASE("tree - Moving subtrees")
+{
+    Scene scene = make_scene();
+
+    // house (with door) becomes a child of ui
+    auto house = scene.move_subtree(3, 5);
+    CHECK(names(scene) ==
+          std::vector<std::string>{"root", "world", "tree", "ui", "house",
+                                   "door"});
+    CHECK(house == 4);
+    CHECK(scene.parent(house) == 3);
+    CHECK(scene.depth(5) == 3);
+    CHECK(scene.subtree_size(1) == 2);
+    CHECK(scene.subtree_size(3) == 3);
+    check_consistent(scene);
+
+    // ... and then a new root of its own
+    house = scene.move_subtree(house, Scene::npos);
+    CHECK(names(scene) ==
+          std::vector<std::string>{"root", "world", "tree", "ui", "house",
+                                   "door"});
+    CHECK(scene.parent(house) == Scene::npos);
+    CHECK(scene.depth(5) == 1);
+    CHECK(scene.subtree_size(0) == 4);
+    check_consistent(scene);
+
+    // ui under the new root house, which ends up in front of it
+    auto ui = scene.move_subtree(3, 4);
+    CHECK(names(scene) ==
+          std::vector<std::string>{"root", "world", "tree", "house", "door",
+                                   "ui"});
+    CHECK(ui == 5);
+    CHECK(scene.parent(ui) == 3);
+    CHECK(scene.subtree_size(3) == 3);
+    check_consistent(scene);
+
+    CHECK_THROWS_AS(scene.move_subtree(0, 2), std::invalid_argument);
+}
+
+TEST_CASE("tree - Moving a subtree under the node in front of it")
+{
+    Scene scene;
+    auto  parent  = scene.emplace_root<Group>("parent");
+    auto  sibling = scene.emplace_child<Group>(parent, "sibling");
+    auto  node    = scene.emplace_child<Mesh>(parent, "node");
+    scene.emplace_child<Mesh>(node, "leaf");
+
+    // Nothing moves: node already follows the subtree of sibling
+    node = scene.move_subtree(node, sibling);
+    CHECK(node == 2);
+    CHECK(names(scene) ==
+          std::vector<std::string>{"parent", "sibling", "node", "leaf"});
+    CHECK(scene.parent(node) == sibling);
+    CHECK(scene.depth(3) == 3);
+    CHECK(scene.subtree_size(sibling) == 3);
+    CHECK(scene[2].name == "node");
+    check_consistent(scene);
+
+    // The same for a root under the root in front of it
+    auto second = scene.emplace_root<Group>("second");
+    second      = scene.move_subtree(second, parent);
+    CHECK(second == 4);
+    CHECK(scene.parent(second) == parent);
+    CHECK(scene.depth(second) == 1);
+    CHECK(scene.subtree_size(parent) == 5);
+    check_consistent(scene);
+}
+
+TEST_CASE("tree - Copy, move and capacity")
+{
+    Scene scene = make_scene();
+    auto  light = scene.emplace_child<Light>(0, "sun");
+    CHECK(scene.holds<Light>(light));
+    CHECK_FALSE(scene.is_copyable());
+
+    // Relocation keeps the offset base subobject valid
+    scene.move_subtree(light, 1);
+    check_consistent(scene);
+    const auto sun = scene.subtree_end(1) - 1;
+    REQUIRE(scene.holds<Light>(sun));
+    CHECK(scene[sun].name == "sun");
+
+    auto copy_scene = [&] { Scene copy = scene; };
+    CHECK_THROWS_AS(copy_scene(), std::logic_error);
+
+    Scene moved = std::move(scene);
+    CHECK(scene.empty());
+    CHECK(moved.size() == 7);
+    CHECK(moved[sun].name == "sun");
+
+    moved.erase(sun);
+    CHECK(moved.is_copyable());
+    Scene copy = moved;
+    CHECK(names(copy) == names(moved));
+
+    for (std::size_t i = copy.size(); i < Scene::capacity(); ++i)
+    {
+        copy.emplace_child<Mesh>(0, "leaf");
+    }
+    CHECK_THROWS_AS(copy.emplace_child<Mesh>(0, "extra"), std::out_of_range);
+    check_consistent(copy);
+}
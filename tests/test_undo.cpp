@@ -0,0 +1,212 @@
+// Copyright 2025 Dr. Matthias Hölzl
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <memory>
+#include <string>
+#include "../include/inline_poly_undo.h"
+
+struct Document
+{
+    std::string text;
+};
+
+struct Edit
+{
+    virtual ~Edit()        = default;
+    virtual void execute() = 0;
+    virtual void undo()    = 0;
+    virtual bool merge(Edit&)
+    {
+        return false;
+    }
+};
+
+struct Insert : Edit
+{
+    Document*   doc;
+    std::size_t pos;
+    std::string text;
+
+    Insert(Document& d, std::size_t p, std::string t) :
+        doc(&d), pos(p), text(std::move(t))
+    {}
+    void execute() override
+    {
+        doc->text.insert(pos, text);
+    }
+    void undo() override
+    {
+        doc->text.erase(pos, text.size());
+    }
+    // Consecutive typing at the end of the previous insert merges
+    bool merge(Edit& next) override
+    {
+        auto* insert = dynamic_cast<Insert*>(&next);
+        if (!insert || insert->pos != pos + text.size())
+        {
+            return false;
+        }
+        text += insert->text;
+        return true;
+    }
+};
+
+struct Replace : Edit
+{
+    Document*            doc;
+    std::string          before;
+    std::string          after;
+    std::shared_ptr<int> tracker;
+
+    Replace(Document& d, std::string a, std::shared_ptr<int> t) :
+        doc(&d), after(std::move(a)), tracker(std::move(t))
+    {}
+    void execute() override
+    {
+        before    = doc->text;
+        doc->text = after;
+    }
+    void undo() override
+    {
+        doc->text = before;
+    }
+};
+
+using History = inline_poly::undo_history<Edit, 1024>;
+
+TEST_CASE("undo - Execute, undo and redo")
+{
+    Document doc;
+    History  history;
+    auto     tracker = std::make_shared<int>(0);
+
+    history.execute<Insert>(doc, 0, "hello");
+    history.execute<Replace>(doc, "HELLO", tracker);
+    CHECK(doc.text == "HELLO");
+    CHECK(history.undo_count() == 2);
+    CHECK_FALSE(history.can_redo());
+
+    CHECK(history.undo());
+    CHECK(doc.text == "hello");
+    CHECK(history.undo());
+    CHECK(doc.text == "");
+    CHECK_FALSE(history.undo());
+    CHECK(history.redo_count() == 2);
+
+    CHECK(history.redo());
+    CHECK(history.redo());
+    CHECK(doc.text == "HELLO");
+    CHECK_FALSE(history.redo());
+
+    SUBCASE("a new edit truncates the redo tail")
+    {
+        history.undo();
+        CHECK(tracker.use_count() == 2);
+        history.execute<Insert>(doc, 0, ">");
+        CHECK(tracker.use_count() == 1); // Replace was destroyed
+        CHECK(doc.text == ">hello");
+        CHECK(history.size() == 2);
+        CHECK_FALSE(history.can_redo());
+    }
+
+    SUBCASE("clear destroys without undoing")
+    {
+        history.clear();
+        CHECK(history.empty());
+        CHECK(tracker.use_count() == 1);
+        CHECK(doc.text == "HELLO");
+    }
+}
+
+TEST_CASE("undo - Consecutive compatible commands merge in place")
+{
+    Document doc;
+    History  history;
+
+    for (char c : std::string("typing"))
+    {
+        history.execute<Insert>(doc, doc.text.size(), std::string(1, c));
+    }
+    CHECK(doc.text == "typing");
+    CHECK(history.size() == 1);
+    CHECK(static_cast<Insert*>(history.top())->text == "typing");
+
+    history.execute<Insert>(doc, 0, "[");
+    CHECK(history.size() == 2);
+
+    history.undo();
+    history.undo();
+    CHECK(doc.text.empty());
+}
+
+TEST_CASE("undo - Oldest commands are evicted to stay within the budget")
+{
+    using SmallHistory = inline_poly::poly_undo_history<Edit, 512>;
+    Document     doc;
+    auto         tracker = std::make_shared<int>(0);
+    SmallHistory history;
+
+    const std::size_t per_command =
+        SmallHistory::record_size(sizeof(Replace));
+    const std::size_t fits = 512 / per_command;
+    REQUIRE(fits >= 2);
+
+    for (std::size_t i = 0; i < fits * 3; ++i)
+    {
+        history.execute<Replace>(doc, std::to_string(i), tracker);
+        CHECK(history.size() <= fits);
+    }
+    CHECK(history.size() == fits);
+    CHECK(history.evicted() == fits * 2);
+    CHECK(tracker.use_count() == static_cast<long>(fits + 1));
+
+    // The surviving commands undo the most recent edits
+    std::size_t undone = 0;
+    while (history.undo())
+    {
+        ++undone;
+    }
+    CHECK(undone == fits);
+    CHECK(doc.text == std::to_string(fits * 2 - 1));
+}
+
+TEST_CASE("undo - Mixed sizes wrap around the ring")
+{
+    using SmallHistory = inline_poly::poly_undo_history<Edit, 512>;
+    Document     doc;
+    auto         tracker = std::make_shared<int>(0);
+    SmallHistory history;
+
+    for (int i = 0; i < 200; ++i)
+    {
+        if (i % 3 == 0)
+        {
+            history.execute<Replace>(doc, std::to_string(i), tracker);
+        }
+        else
+        {
+            // Insert at the front never merges with the previous insert
+            history.execute<Insert>(doc, 0, "x");
+        }
+        if (i % 7 == 0)
+        {
+            history.undo();
+        }
+    }
+
+    // Replaying the whole history backwards and forwards is consistent
+    const std::string final_text = doc.text;
+    const std::size_t count      = history.undo_count();
+    while (history.undo())
+    {
+    }
+    while (history.redo())
+    {
+    }
+    CHECK(history.undo_count() == count);
+    CHECK(doc.text == final_text);
+
+    history.clear();
+    CHECK(tracker.use_count() == 1);
+}
@@ -0,0 +1,152 @@
+// Copyright 2025 Dr. Matthias Hölzl
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <memory>
+#include <string>
+#include "../include/inline_poly_value.h"
+
+struct Pricing
+{
+    virtual ~Pricing()                      = default;
+    virtual double price(double base) const = 0;
+};
+
+struct Flat : Pricing
+{
+    double price(double base) const override
+    {
+        return base;
+    }
+};
+
+struct Discount : Pricing
+{
+    double               rate;
+    std::shared_ptr<int> tracker;
+    Discount(double r, std::shared_ptr<int> t = {}) :
+        rate(r), tracker(std::move(t))
+    {}
+    double price(double base) const override
+    {
+        return base * (1.0 - rate);
+    }
+};
+
+struct Unique : Pricing
+{
+    std::unique_ptr<double> factor = std::make_unique<double>(2.0);
+    double                  price(double base) const override
+    {
+        return base * *factor;
+    }
+};
+
+// Base subobject at a non-zero offset inside the derived object
+struct Tagged
+{
+    std::string tag = "tagged";
+    virtual ~Tagged() = default;
+};
+
+struct Labeled : Tagged, Pricing
+{
+    double price(double base) const override
+    {
+        return base + static_cast<double>(tag.size());
+    }
+};
+
+using Strategy = inline_poly::value<Pricing, 64>;
+
+struct Product
+{
+    double   base = 100.0;
+    Strategy pricing{Flat{}};
+};
+
+TEST_CASE("value - Emplace and access")
+{
+    Strategy strategy;
+    CHECK_FALSE(strategy.has_value());
+    CHECK_FALSE(strategy);
+    CHECK(strategy.get() == nullptr);
+
+    auto& discount = strategy.emplace<Discount>(0.25);
+    CHECK(strategy.holds<Discount>());
+    CHECK(strategy->price(100.0) == doctest::Approx(75.0));
+    CHECK(strategy.get_if<Discount>() == &discount);
+    CHECK(strategy.get_if<Flat>() == nullptr);
+
+    // The object lives inside the value
+    auto* bytes = reinterpret_cast<std::byte*>(strategy.get());
+    CHECK(bytes >= reinterpret_cast<std::byte*>(&strategy));
+    CHECK(bytes < reinterpret_cast<std::byte*>(&strategy) + sizeof(strategy));
+
+    strategy.reset();
+    CHECK_FALSE(strategy.has_value());
+    CHECK(strategy.type_ops() == nullptr);
+}
+
+TEST_CASE("value - Embedded member")
+{
+    Product product;
+    CHECK(product.pricing->price(product.base) == doctest::Approx(100.0));
+
+    product.pricing = Discount{0.5};
+    CHECK(product.pricing->price(product.base) == doctest::Approx(50.0));
+
+    Product copy = product;
+    CHECK(copy.pricing.holds<Discount>());
+    CHECK(copy.pricing.get() != product.pricing.get());
+}
+
+TEST_CASE("value - Copy, move and swap")
+{
+    auto     tracker = std::make_shared<int>(0);
+    Strategy a(std::in_place_type<Discount>, 0.1, tracker);
+    CHECK(tracker.use_count() == 2);
+
+    Strategy b = a;
+    CHECK(tracker.use_count() == 3);
+    CHECK(b.get_if<Discount>()->rate == doctest::Approx(0.1));
+
+    Strategy c = std::move(b);
+    CHECK_FALSE(b.has_value());
+    CHECK(tracker.use_count() == 3);
+
+    Strategy d{Flat{}};
+    swap(c, d);
+    CHECK(c.holds<Flat>());
+    CHECK(d.holds<Discount>());
+
+    d.reset();
+    a = Strategy{};
+    CHECK(tracker.use_count() == 1);
+}
+
+TEST_CASE("value - Non-copyable types move but do not copy")
+{
+    Strategy strategy(std::in_place_type<Unique>);
+    CHECK_FALSE(strategy.is_copyable());
+
+    auto copy_strategy = [&] { Strategy copy = strategy; };
+    CHECK_THROWS_AS(copy_strategy(), std::logic_error);
+
+    Strategy moved = std::move(strategy);
+    CHECK(moved->price(3.0) == doctest::Approx(6.0));
+}
+
+TEST_CASE("value - Base pointer keeps its offset across copy and move")
+{
+    Strategy labeled(std::in_place_type<Labeled>);
+    CHECK(static_cast<void*>(labeled.get()) !=
+          static_cast<void*>(labeled.get_if<Labeled>()));
+
+    Strategy copy = labeled;
+    CHECK(copy->price(1.0) == doctest::Approx(7.0));
+
+    Strategy moved = std::move(copy);
+    CHECK(moved->price(1.0) == doctest::Approx(7.0));
+    CHECK(moved.get_if<Labeled>()->tag == "tagged");
+}
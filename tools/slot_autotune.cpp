@@ -0,0 +1,162 @@
+// Copyright 2025 Dr. Matthias Hölzl
+// slot_autotune.cpp - Recommend a slot configuration from a type histogram
+//
+// Reads one type per line as "name size alignment count" (from a file or
+// stdin; '#' starts a comment), e.g. printed from type_histogram::footprints()
+// at runtime, and prints the projected cost of each layout plus a
+// recommendation.
+//
+// Usage: slot_autotune [--max-classes N] [--cache-line BYTES]
+//                      [--margin FRACTION] [histogram.txt]
+
+#include "../include/inline_poly_autotune.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    void print_plan(const char* label, const inline_poly::slot_plan& plan)
+    {
+        std::printf("%-14s %-13s slots=", label,
+                    inline_poly::to_string(plan.strategy));
+        for (std::size_t c = 0; c < plan.class_count; ++c)
+        {
+            std::printf("%s%zu/%zu x%llu", c ? ", " : "", plan.slot_sizes[c],
+                        plan.slot_alignments[c],
+                        static_cast<unsigned long long>(plan.slot_counts[c]));
+        }
+        if (plan.strategy == inline_poly::slot_strategy::overflow)
+        {
+            std::printf(" (spilled %llu)",
+                        static_cast<unsigned long long>(plan.overflow_count));
+        }
+        std::printf("\n%-14s bytes=%llu cache_lines=%llu\n", "",
+                    static_cast<unsigned long long>(plan.projected_bytes),
+                    static_cast<unsigned long long>(plan.cache_lines));
+    }
+
+    void print_suggestion(const inline_poly::slot_plan& plan)
+    {
+        std::printf("\nSuggested configuration:\n");
+        switch (plan.strategy)
+        {
+            case inline_poly::slot_strategy::single_slot:
+                std::printf("  inline_poly::vector<Base, Capacity, %zu, %zu>\n",
+                            plan.slot_sizes[0], plan.slot_alignments[0]);
+                break;
+            case inline_poly::slot_strategy::size_classes:
+                for (std::size_t c = 0; c < plan.class_count; ++c)
+                {
+                    std::printf("  pool %zu: SlotSize=%zu Alignment=%zu "
+                                "(%llu elements observed)\n",
+                                c, plan.slot_sizes[c], plan.slot_alignments[c],
+                                static_cast<unsigned long long>(
+                                    plan.slot_counts[c]));
+                }
+                break;
+            case inline_poly::slot_strategy::overflow:
+                std::printf("  inline SlotSize=%zu Alignment=%zu, larger types "
+                            "on the heap\n",
+                            plan.slot_sizes[0], plan.slot_alignments[0]);
+                break;
+        }
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    inline_poly::autotune_options options;
+    const char*                   path = nullptr;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--max-classes") == 0 && i + 1 < argc)
+        {
+            options.max_classes = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--cache-line") == 0 && i + 1 < argc)
+        {
+            char* end               = nullptr;
+            options.cache_line_size = std::strtoul(argv[++i], &end, 10);
+            if (*end != '\0' || options.cache_line_size == 0)
+            {
+                std::fprintf(stderr, "slot_autotune: --cache-line needs a "
+                                     "positive number of bytes\n");
+                return EXIT_FAILURE;
+            }
+        }
+        else if (std::strcmp(argv[i], "--margin") == 0 && i + 1 < argc)
+        {
+            options.simplicity_margin = std::strtod(argv[++i], nullptr);
+        }
+        else
+        {
+            path = argv[i];
+        }
+    }
+
+    std::ifstream file;
+    if (path != nullptr)
+    {
+        file.open(path);
+        if (!file)
+        {
+            std::fprintf(stderr, "slot_autotune: cannot open %s\n", path);
+            return EXIT_FAILURE;
+        }
+    }
+    std::istream& in = path ? file : std::cin;
+
+    // Names must outlive the footprints that point to them
+    std::vector<std::string>                 names;
+    std::vector<inline_poly::type_footprint> types;
+    std::string                              line;
+    while (std::getline(in, line))
+    {
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+        std::string        name;
+        std::size_t        size = 0, alignment = 0;
+        unsigned long long count = 0;
+        if (!(fields >> name))
+        {
+            continue;
+        }
+        if (!(fields >> size >> alignment >> count) || alignment == 0)
+        {
+            std::fprintf(stderr, "slot_autotune: malformed line: %s\n",
+                         line.c_str());
+            return EXIT_FAILURE;
+        }
+        names.push_back(name);
+        types.push_back({.size = size, .alignment = alignment, .count = count});
+    }
+    for (std::size_t i = 0; i < types.size(); ++i)
+    {
+        types[i].name = names[i].c_str();
+    }
+
+    try
+    {
+        const auto result = inline_poly::recommend_slots(types, options);
+        print_plan("single slot", result.single);
+        print_plan("size classes", result.split);
+        print_plan("overflow", result.overflow);
+        std::printf("\n");
+        print_plan("RECOMMENDED", result.recommended);
+        print_suggestion(result.recommended);
+    }
+    catch (const std::exception& e)
+    {
+        std::fprintf(stderr, "slot_autotune: %s\n", e.what());
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}